@@ -17,48 +17,64 @@ ASMParser::ASMParser(string filename)
   } else {
     string line;
     while( getline(in, line)){
-      string opcode("");
-      string operand[80];
-      int operand_count = 0;
-
       if(line.length() == 0){
         continue;
       }
 
-      getTokens(line, opcode, operand, operand_count);
-
-      if(opcode.length() == 0 && operand_count != 0){
-        // No opcode but operands
+      if(!parseLine(line, i)){
         myFormatCorrect = false;
         break;
       }
+      myInstructions.push_back(i);
 
-      Opcode o = opcodes.getOpcode(opcode);      
-      if(o == UNDEFINED){
-        // invalid opcode specified
-        myFormatCorrect = false;
-        break;
-      }
+    }
+  }
+  in.close();
+  myIndex = 0;
+}
 
-      bool success = getOperands(i, o, operand, operand_count);
-      if(!success){
-        myFormatCorrect = false;
-        break;
-      }
+bool ASMParser::parseLine(string line, Instruction &i)
+  // Given a line of MIPS assembly, checks its syntax and stores the 
+  // corresponding Instruction into i.  Returns false if the line is incorrect.
+{
+  string opcode("");
+  string operand[80];
+  int operand_count = 0;
 
+  getTokens(line, opcode, operand, operand_count);
 
-      string encoding = encode(i);
-      i.setEncoding(encoding);
+  if(opcode.length() == 0 && operand_count != 0){
+    // No opcode but operands
+    return false;
+  }
 
-      i.setAssembly(line);
-      myInstructions.push_back(i);
+  Opcode o = opcodes.getOpcode(opcode);      
+  if(o == UNDEFINED){
+    // invalid opcode specified
+    return false;
+  }
 
-    }
+  bool success = getOperands(i, o, operand, operand_count);
+  if(!success){
+    return false;
   }
-  in.close();
-  myIndex = 0;
+
+  string encoding = encode(i);
+  i.setEncoding(encoding);
+
+  i.setAssembly(line);
+  return true;
 }
 
+ASMParser::ASMParser()
+  // Creates a parser holding no Instructions, for parsing lines one at
+  // a time with parseLine().
+{
+  myFormatCorrect = true;
+  myLabelAddress = 0x400000;
+  myLabels.clear();
+  myIndex = 0;
+}
 
 Instruction ASMParser::getNextInstruction()
   // Iterator that returns the next Instruction in the list of Instructions.
@@ -73,6 +89,14 @@ Instruction ASMParser::getNextInstruction()
 
 }
 
+size_t ASMParser::getMemoryUsage() const
+  // Returns the bytes the parser holds, with the instructions it read
+{
+  // each label is a node of the map, with its links and color
+  size_t labels = myLabels.size() * (sizeof(pair<const string, int>) + 4 * sizeof(void*));
+  return sizeof(*this) + MemoryAccount::objectVectorBytes(myInstructions) + labels;
+}
+
 void ASMParser::getTokens(string line,
 			       string &opcode,
 			       string *operand,
@@ -234,9 +258,17 @@ bool ASMParser::getOperands(Instruction &i, Opcode o,
     }
     else{ 
       if(opcodes.isIMMLabel(o)){  // Can the operand be a label?
-        // Assign the immediate field an address
-        imm = myLabelAddress;
-        myLabelAddress += 4;  // increment the label generator
+        // Assign the immediate field the address of the label, a new one
+        // the first time it is used (a branch takes it as an offset
+        // instead, kept within its 16-bit field)
+        map<string, int>::iterator label = myLabels.find(operand[imm_p]);
+        if(label == myLabels.end()){
+          label = myLabels.insert(make_pair(operand[imm_p], myLabelAddress)).first;
+          myLabelAddress += 4;  // increment the label generator
+        }
+        imm = label->second;
+        if(opcodes.isBranch(o))
+          imm = 4 + ((imm - 0x400000) & 0xfffc);
       } else  // There is an error
         return false;
     }
@@ -287,12 +319,17 @@ string ASMParser::encodeI(Instruction &i)
 {
   string encode = "";
 
+  // a branch offset is in words, as for J
+  int imm = i.getImmediate();
+  if (opcodes.isIMMLabel(i.getOpcode()))
+    imm /= 4;
+
   // If ITYPE, Opcode + Rs + Rt + Immediate
   encode +=
     opcodes.getOpcodeField(i.getOpcode()) +
     cvtToBinary(i.getRS(), rgstLen) +
     cvtToBinary(i.getRT(), rgstLen) +
-    cvtToBinary(i.getImmediate(), immILen);
+    cvtToBinary(imm, immILen);
   
   return encode;
 }
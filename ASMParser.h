@@ -10,6 +10,7 @@
 #include "OpcodeTable.h"
 #include <math.h>
 #include <vector>
+#include <map>
 #include <sstream>
 #include <stdlib.h>
 #include "OpcodeTable.h"
@@ -27,6 +28,10 @@ class ASMParser{
   // checks syntactic correctness of file and creates a list of Instructions.
   ASMParser(string filename);
 
+  // Creates a parser holding no Instructions, for parsing lines one at
+  // a time with parseLine().
+  ASMParser();
+
   // Returns true if the file specified was syntactically correct.  Otherwise,
   // returns false.
   bool isFormatCorrect() { return myFormatCorrect; };
@@ -34,7 +39,17 @@ class ASMParser{
   // Iterator that returns the next Instruction in the list of Instructions.
   Instruction getNextInstruction();
 
+  // Given a line of MIPS assembly, checks its syntax and stores the
+  // corresponding Instruction into i.  Returns false if the line is incorrect.
+  bool parseLine(string line, Instruction &i);
+
+  // Returns the bytes the parser holds, with the instructions it read
+  size_t getMemoryUsage() const;
+
  private:
+  // measures the private steps of parsing
+  friend class ParserBenchmark;
+
   vector<Instruction> myInstructions;      // list of Instructions
   int myIndex;                             // iterator index
   bool myFormatCorrect;
@@ -49,6 +64,8 @@ class ASMParser{
   RegisterTable registers;                 // encodings for registers
   OpcodeTable opcodes;                     // encodings of opcodes
   int myLabelAddress;   // Used to assign labels addresses
+  map<string, int> myLabels;   // Address assigned to each label, so that a
+                               // label always gets the same one
 
   // Decomposes a line of assembly code into strings for the opcode field and operands,
   // checking for syntax errors and counting the number of operands.
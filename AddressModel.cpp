@@ -0,0 +1,161 @@
+// Name: Maxine Xin
+#include "AddressModel.h"
+
+#include <cstdlib>
+#include <sstream>
+
+/* creates a model with the registers at their initial values
+ */
+AddressModel::AddressModel() {
+  myRegisters[0] = 0;
+  for (int r = 1; r < NUMREGISTERS; r++) {
+    myRegisters[r] = REGION_BASE + REGION_SIZE * r;
+  }
+  myHI = 0;
+  myLO = 0;
+}
+
+/* returns the effective address of each instruction in order (0 for the
+ * ones that are not loads), from their annotations or the model, and
+ * sets numAnnotated to the number of loads that were annotated
+ */
+vector<uint32_t> AddressModel::getAddresses(const vector<Instruction> &instructions,
+                                            unsigned int &numAnnotated) {
+  vector<uint32_t> addresses(instructions.size(), 0);
+  numAnnotated = 0;
+  for (unsigned int i = 0; i < instructions.size(); i++) {
+    uint32_t modeled = execute(instructions[i]);
+    if (!myOpcodeTable.isIMMMemory(instructions[i].getOpcode()))
+      continue;
+    if (getAnnotation(instructions[i].getAssembly(), addresses[i])) {
+      numAnnotated++;
+    } else {
+      addresses[i] = modeled;
+    }
+  }
+  return addresses;
+}
+
+/* returns the address each instruction is fetched from
+ */
+vector<uint32_t> AddressModel::getFetchAddresses(const vector<Instruction> &instructions) {
+  OpcodeTable opcodeTable;
+  vector<uint32_t> addresses(instructions.size(), 0);
+  uint32_t pc = TEXT_BASE;
+  for (unsigned int i = 0; i < instructions.size(); i++) {
+    addresses[i] = pc;
+    if (opcodeTable.isIMMLabel(instructions[i].getOpcode()) && isTaken(instructions[i]))
+      pc = getTarget(instructions[i], pc);
+    else
+      pc += 4;
+  }
+  return addresses;
+}
+
+/* returns true if the jump or branch inst is taken
+ */
+bool AddressModel::isTaken(const Instruction &inst) {
+  if (inst.getOpcode() != BEQ)
+    return true;
+  const string &assembly = inst.getAssembly();
+  string::size_type comment = assembly.find('#');
+  if (comment == string::npos)
+    return false;
+  stringstream ss(assembly.substr(comment + 1));
+  string token;
+  while (ss >> token) {
+    if (token == "T")
+      return true;
+    if (token == "N")
+      return false;
+  }
+  return false;
+}
+
+/* returns the destination of the jump or branch inst fetched from pc
+ */
+uint32_t AddressModel::getTarget(const Instruction &inst, uint32_t pc) {
+  // the immediates are in bytes, once parsed
+  if (inst.getOpcode() == BEQ)
+    return pc + 4 + inst.getImmediate();
+  return (pc & 0xf0000000) | ((uint32_t)inst.getImmediate() & 0x0ffffffc);
+}
+
+/* reads the address annotated on assembly into address; returns false
+ * if there is none
+ */
+bool AddressModel::getAnnotation(const string &assembly, uint32_t &address) {
+  string::size_type comment = assembly.find('#');
+  if (comment == string::npos)
+    return false;
+  string::size_type at = assembly.find('@', comment);
+  if (at == string::npos)
+    return false;
+  const char *start = assembly.c_str() + at + 1;
+  char *end;
+  unsigned long value = strtoul(start, &end, 0);
+  if (end == start)
+    return false;
+  address = value;
+  return true;
+}
+
+/* updates the registers as inst does, and returns the address it
+ * reads if it is a load
+ */
+uint32_t AddressModel::execute(const Instruction &inst) {
+  // the registers of an instruction are in range once parsed, but the
+  // unused ones may not be
+  uint32_t rs = (inst.getRS() >= 0 && inst.getRS() < NUMREGISTERS) ? myRegisters[inst.getRS()] : 0;
+  uint32_t rt = (inst.getRT() >= 0 && inst.getRT() < NUMREGISTERS) ? myRegisters[inst.getRT()] : 0;
+  int32_t imm = inst.getImmediate();
+  uint32_t address = 0;
+  int dest = -1;
+  uint32_t result = 0;
+  switch (inst.getOpcode()) {
+  case ADD:
+    dest = inst.getRD();
+    result = rs + rt;
+    break;
+  case ADDI:
+    dest = inst.getRT();
+    result = rs + imm;
+    break;
+  case XOR:
+    dest = inst.getRD();
+    result = rs ^ rt;
+    break;
+  case SLL:
+    dest = inst.getRD();
+    result = rt << (imm & 31);
+    break;
+  case SLT:
+    dest = inst.getRD();
+    result = (int32_t)rs < (int32_t)rt;
+    break;
+  case SLTI:
+    dest = inst.getRT();
+    result = (int32_t)rs < imm;
+    break;
+  case MULT: {
+    int64_t product = (int64_t)(int32_t)rs * (int32_t)rt;
+    myHI = (uint32_t)((uint64_t)product >> 32);
+    myLO = (uint32_t)product;
+    break;
+  }
+  case MFLO:
+    dest = inst.getRD();
+    result = myLO;
+    break;
+  case LB:
+    address = rs + imm;
+    dest = inst.getRT();
+    result = address;
+    break;
+  default:
+    break;
+  }
+  if (dest > 0 && dest < NUMREGISTERS)
+    myRegisters[dest] = result;
+  return address;
+}
@@ -0,0 +1,83 @@
+// Name: Maxine Xin
+#ifndef __ADDRESSMODEL_H__
+#define __ADDRESSMODEL_H__
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "Instruction.h"
+#include "OpcodeTable.h"
+
+using namespace std;
+
+/* This class works out the effective address each load (LB) reads, and
+ * the address each instruction is fetched from, for a DataCache to decide
+ * how long they take.
+ *
+ * A trace can give the address of a load itself, in a comment on its line
+ * starting with @ (e.g. lb $1, 4($2) # @0x10010004, in decimal or hex).
+ * Otherwise, the address is the value of its base register plus its offset,
+ * with the values of the registers modeled by executing the instructions
+ * before it: each register but $0 starts out pointing to a region of its
+ * own (0x10010000 + 4096 * its number), ADD, ADDI, XOR, SLL, SLT, SLTI,
+ * MULT and MFLO compute their results, and since the byte a load reads is
+ * not known, LB leaves the address it read in its destination, as if it
+ * loaded a pointer to the same region.
+ *
+ * The instructions are taken to be the ones executed, in order: the first
+ * one is fetched from 0x00400000, each one from the word after the one
+ * before it, and the one after a jump, or a taken branch, from its
+ * destination (the address of J, in the region of the jump, or the word
+ * after BEQ plus its offset). A branch is taken if its line is annotated
+ * so (e.g. beq $1, $2, loop # T), and not taken if it is annotated # N or
+ * not annotated.
+ */
+class AddressModel {
+  public:
+    /* creates a model with the registers at their initial values
+     */
+    AddressModel();
+
+    /* returns the effective address of each instruction in order (0 for the
+     * ones that are not loads), from their annotations or the model, and
+     * sets numAnnotated to the number of loads that were annotated
+     */
+    vector<uint32_t> getAddresses(const vector<Instruction> &instructions,
+                                  unsigned int &numAnnotated);
+
+    /* returns the address each instruction is fetched from
+     */
+    static vector<uint32_t> getFetchAddresses(const vector<Instruction> &instructions);
+
+    /* returns true if the jump or branch inst is taken
+     */
+    static bool isTaken(const Instruction &inst);
+
+    /* returns the destination of the jump or branch inst fetched from pc
+     */
+    static uint32_t getTarget(const Instruction &inst, uint32_t pc);
+
+    /* reads the address annotated on assembly into address; returns false
+     * if there is none
+     */
+    static bool getAnnotation(const string &assembly, uint32_t &address);
+
+  private:
+    /* updates the registers as inst does, and returns the address it
+     * reads if it is a load
+     */
+    uint32_t execute(const Instruction &inst);
+
+    const static int NUMREGISTERS = 32;
+    const static uint32_t REGION_BASE = 0x10010000;
+    const static uint32_t REGION_SIZE = 4096;
+    const static uint32_t TEXT_BASE = 0x00400000;
+
+    uint32_t myRegisters[NUMREGISTERS];
+    uint32_t myHI;
+    uint32_t myLO;
+    OpcodeTable myOpcodeTable;
+};
+
+#endif
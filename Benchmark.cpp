@@ -0,0 +1,155 @@
+// Name: Maxine Xin
+#include "Pipeline.h"
+#include "StallPipeline.h"
+#include "ForwardingPipeline.h"
+#include "OutOfOrderPipeline.h"
+#include "ASMParser.h"
+#include "BinaryParser.h"
+#include "DependencyChecker.h"
+#include "MemoizedSimulation.h"
+#include "WorkloadGenerator.h"
+#include "Profiler.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+/* This file runs PIPESIM end to end on a synthetic list of instructions,
+ * and writes the time and throughput of each phase as one line of JSON to
+ * stdout (see Profiler::writeJSON): generating the instructions, parsing
+ * them as assembly and as binary encodings, their dependence analysis, and,
+ * for each pipeline, its initialization, its memoized simulation and its
+ * cycle-by-cycle simulation (only up to a number of instructions, so that
+ * the largest sizes only take the time of the memoized one), then the
+ * cycle-by-cycle simulation of an out-of-order pipeline, which has no
+ * memoized one, at every size. The peak RSS
+ * is that of the whole run, so each size should be run in a process of its
+ * own, as make benchmark does.
+ *
+ * usage: BENCHMARK <numInstructions> [-seed X] [-cyclelimit C]
+ *   -seed X: seed of the instructions (default 1)
+ *   -cyclelimit C: only simulates the in-order pipelines cycle by cycle up
+ *                  to C instructions (default 1000000)
+ *
+ */
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    cerr << "Need to specify the number of instructions to run." << endl;
+    exit(1);
+  }
+
+  unsigned long long numInstructions = strtoull(argv[1], NULL, 10);
+  unsigned int seed = 1;
+  unsigned long long cycleLimit = 1000000;
+  for (int arg = 2; arg < argc; arg++) {
+    string option = argv[arg];
+    if (option == "-seed" && arg + 1 < argc) {
+      seed = atoi(argv[++arg]);
+    } else if (option == "-cyclelimit" && arg + 1 < argc) {
+      cycleLimit = strtoull(argv[++arg], NULL, 10);
+    } else {
+      cerr << "Unknown option " << option << endl;
+      exit(1);
+    }
+  }
+
+  Profiler profiler;
+  string asmFilename = "benchmark_" + to_string(numInstructions) + ".asm";
+  string binaryFilename = "benchmark_" + to_string(numInstructions) + ".mach";
+
+  // the same instructions, in assembly and in binary
+  profiler.begin("generate", "");
+  for (int binary = 0; binary <= 1; binary++) {
+    WorkloadGenerator generator(seed);
+    generator.setTypicalMix();
+    ofstream out((binary ? binaryFilename : asmFilename).c_str());
+    if (!out || !generator.write(out, numInstructions, binary)) {
+      cerr << "Cannot write the instructions." << endl;
+      exit(1);
+    }
+  }
+  profiler.end(2 * numInstructions, 0);
+
+  vector<Instruction> instructions;
+  Instruction inst;
+  profiler.begin("parse_binary", "");
+  BinaryParser *bParser = new BinaryParser(binaryFilename);
+  if (!bParser -> isFormatCorrect()) {
+    cerr << "Format of " << binaryFilename << " is incorrect." << endl;
+    exit(1);
+  }
+  inst = bParser -> getNextInstruction();
+  while (inst.getOpcode() != UNDEFINED) {
+    instructions.push_back(inst);
+    inst = bParser -> getNextInstruction();
+  }
+  delete bParser;
+  profiler.end(instructions.size(), 0);
+
+  instructions.clear();
+  profiler.begin("parse_asm", "");
+  ASMParser *aParser = new ASMParser(asmFilename);
+  if (!aParser -> isFormatCorrect()) {
+    cerr << "Format of " << asmFilename << " is incorrect." << endl;
+    exit(1);
+  }
+  inst = aParser -> getNextInstruction();
+  while (inst.getOpcode() != UNDEFINED) {
+    instructions.push_back(inst);
+    inst = aParser -> getNextInstruction();
+  }
+  delete aParser;
+  profiler.end(instructions.size(), 0);
+  remove(asmFilename.c_str());
+  remove(binaryFilename.c_str());
+
+  profiler.begin("dependences", "");
+  {
+    DependencyChecker checker;
+    for (unsigned int i = 0; i < instructions.size(); i++) {
+      checker.addInstruction(instructions[i]);
+    }
+  }
+  profiler.end(instructions.size(), 0);
+
+  for (int model = 0; model < 4; model++) {
+    // memoized, then cycle by cycle on a pipeline of its own
+    for (int memoized = 1; memoized >= 0; memoized--) {
+      if (!memoized && instructions.size() > cycleLimit && model != 3)
+        continue;
+      if (memoized && model == 3)
+        continue;
+      Pipeline *pipeline;
+      if (model == 0)
+        pipeline = new Pipeline();
+      else if (model == 1)
+        pipeline = new StallPipeline();
+      else if (model == 2)
+        pipeline = new ForwardingPipeline();
+      else
+        pipeline = new OutOfOrderPipeline("OOO");
+
+      profiler.begin(memoized ? "initialize" : "initialize_cycle", pipeline -> getName());
+      pipeline -> initialize(instructions);
+      profiler.end(instructions.size(), 0);
+
+      profiler.begin(memoized ? "simulation_memo" : "simulation", pipeline -> getName());
+      if (memoized) {
+        MemoizedSimulation memoSim;
+        memoSim.execute(pipeline, instructions);
+      } else {
+        pipeline -> execute();
+      }
+      profiler.end(instructions.size(), instructions.empty() ? 0 :
+                   pipeline -> getExeTimes().back());
+      delete pipeline;
+    }
+  }
+
+  profiler.writeJSON(cout);
+  return(0);
+}
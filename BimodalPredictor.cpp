@@ -0,0 +1,43 @@
+// Name: Maxine Xin
+#include "BimodalPredictor.h"
+
+#include "MemoryAccount.h"
+
+/* creates a predictor of numEntries counters (a power of two)
+ */
+BimodalPredictor::BimodalPredictor(unsigned int numEntries) {
+  myName = "bimodal";
+  myMask = numEntries - 1;
+  // 0x55 holds 4 counters of 1
+  myCounters.assign((numEntries + 3) / 4, 0x55);
+}
+
+/* returns true if the branch fetched from pc is predicted taken
+ */
+bool BimodalPredictor::predict(uint32_t pc) {
+  return getCounter(getIndex(pc)) >= 2;
+}
+
+/* learns that the branch fetched from pc was taken to target, or not
+ * taken
+ */
+void BimodalPredictor::update(uint32_t pc, bool taken, uint32_t target) {
+  unsigned int index = getIndex(pc);
+  unsigned int counter = getCounter(index);
+  if (taken && counter < 3)
+    setCounter(index, counter + 1);
+  else if (!taken && counter > 0)
+    setCounter(index, counter - 1);
+}
+
+/* returns the bytes held by the predictor
+ */
+size_t BimodalPredictor::getMemoryUsage() const {
+  return sizeof(*this) + MemoryAccount::vectorBytes(myCounters);
+}
+
+/* returns the counter the branch fetched from pc is predicted by
+ */
+unsigned int BimodalPredictor::getIndex(uint32_t pc) {
+  return (pc >> 2) & myMask;
+}
@@ -0,0 +1,57 @@
+// Name: Maxine Xin
+#ifndef __BIMODALPREDICTOR_H__
+#define __BIMODALPREDICTOR_H__
+
+#include <vector>
+
+#include "BranchPredictor.h"
+
+/* This class predicts each branch with a 2-bit saturating counter, picked
+ * by the address it is fetched from among N (a power of two): a branch is
+ * predicted taken if its counter is 2 or 3, and its outcome moves the
+ * counter one step towards 3 (taken) or 0 (not taken). The counters start
+ * at 1 (weakly not taken), and are packed 4 to a byte.
+ */
+class BimodalPredictor : public BranchPredictor {
+  public:
+    /* creates a predictor of numEntries counters (a power of two)
+     */
+    BimodalPredictor(unsigned int numEntries);
+
+    /* destructor
+     */
+    virtual ~BimodalPredictor() {};
+
+    /* returns true if the branch fetched from pc is predicted taken
+     */
+    bool predict(uint32_t pc);
+
+    /* learns that the branch fetched from pc was taken to target, or not
+     * taken
+     */
+    virtual void update(uint32_t pc, bool taken, uint32_t target);
+
+    /* returns the bytes held by the predictor
+     */
+    size_t getMemoryUsage() const;
+
+  protected:
+    /* returns the counter the branch fetched from pc is predicted by
+     */
+    virtual unsigned int getIndex(uint32_t pc);
+
+    /* returns / sets the value (0 to 3) of counter index
+     */
+    unsigned int getCounter(unsigned int index) {
+      return (myCounters[index >> 2] >> ((index & 3) * 2)) & 3;
+    };
+    void setCounter(unsigned int index, unsigned int value) {
+      unsigned int shift = (index & 3) * 2;
+      myCounters[index >> 2] = (myCounters[index >> 2] & ~(3 << shift)) | (value << shift);
+    };
+
+    unsigned int myMask;           // number of counters - 1
+    vector<uint8_t> myCounters;    // 4 counters per byte, the first in the low bits
+};
+
+#endif
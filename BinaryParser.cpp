@@ -20,23 +20,10 @@ BinaryParser::BinaryParser(string filename) {
   else {
     string line;
     while (getline(in, line)) {
-      if (!checkSyntax(line)) {
-        //if there is something wrong with the length or there are
-        //other characters other than '0' and '1'
-        myFormatCorrect = false;
-        break;
-      } 
-   
-      //if the syntax is correct, check whether is a valid binary representation
-      //of an instruction, and decode and store instruction if valid
-      if (!decode2Inst(i, line)) {
+      if (!parseLine(line, i)) {
         myFormatCorrect = false;
         break;
       }
-
-      string asmStr = cvt2ASM(i);
-      i.setAssembly(asmStr);     
-      i.setEncoding(line);
       myInstructions.push_back(i);
     }
   }
@@ -46,6 +33,35 @@ BinaryParser::BinaryParser(string filename) {
   return;
 }
 
+// creates a parser holding no instructions, for parsing lines one at
+// a time with parseLine()
+BinaryParser::BinaryParser() {
+  myFormatCorrect = true;
+  myIndex = 0;
+}
+
+// binaryLine: a line of 32 bit binary string
+// checks its syntax and whether it is a valid encoding, and if so, stores
+// the corresponding instruction (with its assembly) into i and returns
+// true; returns false otherwise
+bool BinaryParser::parseLine(string binaryLine, Instruction &i) {
+  if (!checkSyntax(binaryLine)) {
+    //if there is something wrong with the length or there are
+    //other characters other than '0' and '1'
+    return false;
+  }
+
+  //if the syntax is correct, check whether is a valid binary representation
+  //of an instruction, and decode and store instruction if valid
+  if (!decode2Inst(i, binaryLine))
+    return false;
+
+  string asmStr = cvt2ASM(i);
+  i.setAssembly(asmStr);
+  i.setEncoding(binaryLine);
+  return true;
+}
+
 // Iterator that returns the next Instruction in the list of Instructions.
 Instruction BinaryParser::getNextInstruction() {
   if (myIndex < (int)(myInstructions.size())) {
@@ -56,6 +72,11 @@ Instruction BinaryParser::getNextInstruction() {
   return i;
 }
 
+// returns the bytes the parser holds, with the instructions it read
+size_t BinaryParser::getMemoryUsage() const {
+  return sizeof(*this) + MemoryAccount::objectVectorBytes(myInstructions);
+}
+
 
 // binaryLine: the line of the binary string to be checked
 // returns true if that binary representation is correct in 
@@ -303,7 +324,7 @@ string BinaryParser::cvt2ASM(Instruction &i) {
 string BinaryParser::convert2RTypeASM(Opcode op, Instruction &i) {
   string strASM = "";
   int numOperands = myOpTable.numOperands(op);
-  vector<string> operands (numOperands);      // stores the string representation
+  string operands[MAXOPERANDS];               // stores the string representation
                                               // for each operand based on their position
   
   string name = myOpTable.getInstName(op);
@@ -326,9 +347,9 @@ string BinaryParser::convert2RTypeASM(Opcode op, Instruction &i) {
   
   strASM += (name + " ");
 
-  for (unsigned int j = 0; j < operands.size() - 1; j++) 
+  for (int j = 0; j < numOperands - 1; j++) 
     strASM += (operands[j] + ", ");
-  strASM += operands[operands.size() - 1];  
+  strASM += operands[numOperands - 1];  
 
   return strASM;
 }
@@ -339,7 +360,7 @@ string BinaryParser::convert2RTypeASM(Opcode op, Instruction &i) {
 string BinaryParser::convert2ITypeASM(Opcode op, Instruction &i) {
   string strASM = "";
   int numOperands = myOpTable.numOperands(op);
-  vector<string> operands (numOperands);      // stores the string representation
+  string operands[MAXOPERANDS];               // stores the string representation
                                               // for each operand based on their position
   
   string name = myOpTable.getInstName(op);
@@ -367,10 +388,10 @@ string BinaryParser::convert2ITypeASM(Opcode op, Instruction &i) {
     // if expects memory address
     strASM += (operands[0] + ", " + operands[1] + "(" + operands[2] + ")");
   } else {
-    for (unsigned int j = 0; j < operands.size() - 1; j++) {
+    for (int j = 0; j < numOperands - 1; j++) {
       strASM += (operands[j] + ", ");
     }
-    strASM += operands[operands.size() - 1];  
+    strASM += operands[numOperands - 1];  
   }
 
   return strASM;
@@ -29,6 +29,10 @@ class BinaryParser {
     // if valid, decode the binary and store the corresponding instruction.
     BinaryParser(string filename);
 
+    // creates a parser holding no instructions, for parsing lines one at
+    // a time with parseLine()
+    BinaryParser();
+
     // return true if the input file is correct in syntax and has valid 
     // encodings of an ASM instruction;
     // otherwise, return false.
@@ -39,7 +43,19 @@ class BinaryParser {
     // Iterator that returns the next Instruction in the list of Instructions.
     Instruction getNextInstruction();
 
+    // binaryLine: a line of 32 bit binary string
+    // checks its syntax and whether it is a valid encoding, and if so, stores
+    // the corresponding instruction (with its assembly) into i and returns
+    // true; returns false otherwise
+    bool parseLine(string binaryLine, Instruction &i);
+
+    // returns the bytes the parser holds, with the instructions it read
+    size_t getMemoryUsage() const;
+
   private:
+    // measures the private steps of decoding
+    friend class ParserBenchmark;
+
     vector<Instruction> myInstructions;    // list of instructions
     bool myFormatCorrect;                  // status representing the syntax
                                            // correctness and validity of a
@@ -55,6 +71,7 @@ class BinaryParser {
     const static int IMMJLEN = 26;                // length of J type immediate field
     const static int FUNCLEN = 6;                 // length of func field
     const static int ENCODELEN = 32;              // length of a valid encoding
+    const static int MAXOPERANDS = 3;             // most operands of an instruction
 
     const string MULT_4 = "00";        // appends to the end of an encoding to *4
     const string FOREMOST_4_BITS_PC = "0000"; //4 most significant bits in PC             
@@ -0,0 +1,51 @@
+// Name: Maxine Xin
+#include "BranchPredictor.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+#include "StaticPredictor.h"
+#include "BimodalPredictor.h"
+#include "GsharePredictor.h"
+#include "BranchTargetBuffer.h"
+
+/* returns true if n is a power of two
+ */
+static bool isPowerOfTwo(int n) {
+  return n > 0 && (n & (n - 1)) == 0;
+}
+
+/* creates the predictor described by spec (nottaken, bimodal:N,
+ * gshare:N:H or btb:N, for N entries, a power of two, and H bits of
+ * global history); returns NULL if spec cannot be read
+ */
+BranchPredictor *BranchPredictor::create(const string &spec) {
+  stringstream ss(spec);
+  vector<string> items;
+  string item;
+  while (getline(ss, item, ':')) {
+    items.push_back(item);
+  }
+  if (items.empty())
+    return NULL;
+
+  BranchPredictor *predictor = NULL;
+  int entries = (items.size() > 1) ? atoi(items[1].c_str()) : 0;
+  if (items[0] == "nottaken" && items.size() == 1) {
+    predictor = new StaticPredictor();
+  } else if (items[0] == "bimodal" && items.size() == 2 && isPowerOfTwo(entries)) {
+    predictor = new BimodalPredictor(entries);
+  } else if (items[0] == "gshare" && items.size() == 3 && isPowerOfTwo(entries)) {
+    int historyBits = atoi(items[2].c_str());
+    if (historyBits < 1 || historyBits > 30)
+      return NULL;
+    predictor = new GsharePredictor(entries, historyBits);
+  } else if (items[0] == "btb" && items.size() == 2 && isPowerOfTwo(entries)) {
+    predictor = new BranchTargetBuffer(entries);
+  } else {
+    return NULL;
+  }
+  predictor->myName = spec;
+  return predictor;
+}
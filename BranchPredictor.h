@@ -0,0 +1,58 @@
+// Name: Maxine Xin
+#ifndef __BRANCHPREDICTOR_H__
+#define __BRANCHPREDICTOR_H__
+
+#include <stdint.h>
+
+#include <string>
+
+using namespace std;
+
+/* This class is the interface of the branch predictors, which predict at
+ * fetch whether a jump or branch is taken (and, for a branch target
+ * buffer, where to), and learn from its outcome once it is known.
+ *
+ * The branches are identified by the address they are fetched from (see
+ * AddressModel), and go through the predictor in program order, each
+ * predicted and then updated before the next one.
+ */
+class BranchPredictor {
+  public:
+    /* destructor
+     */
+    virtual ~BranchPredictor() {};
+
+    /* returns true if the branch fetched from pc is predicted taken
+     */
+    virtual bool predict(uint32_t pc) = 0;
+
+    /* learns that the branch fetched from pc was taken to target, or not
+     * taken
+     */
+    virtual void update(uint32_t pc, bool taken, uint32_t target) = 0;
+
+    /* reads the destination predicted for the branch fetched from pc into
+     * target; returns false if there is none (the predictors that only
+     * predict the direction leave it to DECODE)
+     */
+    virtual bool getTarget(uint32_t pc, uint32_t &target) { return false; };
+
+    /* returns the bytes held by the predictor
+     */
+    virtual size_t getMemoryUsage() const = 0;
+
+    /* returns the name of the predictor, as given to create()
+     */
+    string getName() { return myName; };
+
+    /* creates the predictor described by spec (nottaken, bimodal:N,
+     * gshare:N:H or btb:N, for N entries, a power of two, and H bits of
+     * global history); returns NULL if spec cannot be read
+     */
+    static BranchPredictor *create(const string &spec);
+
+  protected:
+    string myName;
+};
+
+#endif
@@ -0,0 +1,49 @@
+// Name: Maxine Xin
+#include "BranchTargetBuffer.h"
+
+#include "MemoryAccount.h"
+
+/* creates an empty buffer of numEntries entries (a power of two)
+ */
+BranchTargetBuffer::BranchTargetBuffer(unsigned int numEntries) {
+  myName = "btb";
+  myMask = numEntries - 1;
+  myTags.assign(numEntries, 0);
+  myTargets.assign(numEntries, 0);
+}
+
+/* returns true if the branch fetched from pc is in the buffer
+ */
+bool BranchTargetBuffer::predict(uint32_t pc) {
+  // the addresses are word aligned, which leaves the low bit for valid
+  return myTags[(pc >> 2) & myMask] == (pc | 1);
+}
+
+/* puts the branch fetched from pc into the buffer if it was taken to
+ * target, or takes it out if it was not taken
+ */
+void BranchTargetBuffer::update(uint32_t pc, bool taken, uint32_t target) {
+  unsigned int index = (pc >> 2) & myMask;
+  if (taken) {
+    myTags[index] = pc | 1;
+    myTargets[index] = target;
+  } else if (myTags[index] == (pc | 1)) {
+    myTags[index] = 0;
+  }
+}
+
+/* reads the destination held for the branch fetched from pc into
+ * target; returns false if it is not in the buffer
+ */
+bool BranchTargetBuffer::getTarget(uint32_t pc, uint32_t &target) {
+  if (!predict(pc))
+    return false;
+  target = myTargets[(pc >> 2) & myMask];
+  return true;
+}
+
+/* returns the bytes held by the buffer
+ */
+size_t BranchTargetBuffer::getMemoryUsage() const {
+  return sizeof(*this) + MemoryAccount::vectorBytes(myTags) + MemoryAccount::vectorBytes(myTargets);
+}
@@ -0,0 +1,48 @@
+// Name: Maxine Xin
+#ifndef __BRANCHTARGETBUFFER_H__
+#define __BRANCHTARGETBUFFER_H__
+
+#include <vector>
+
+#include "BranchPredictor.h"
+
+/* This class models a direct-mapped branch target buffer of N entries (a
+ * power of two), each holding the address of a branch that was taken
+ * (with a valid bit) and where to. On its own, it predicts a branch taken
+ * to the destination it holds if it is there, and not taken otherwise: a
+ * branch is put in when it is taken, and taken out when it is not. Along
+ * with another predictor, it gives the destinations of the branches that
+ * one predicts taken, so that fetching goes on there without waiting for
+ * DECODE.
+ */
+class BranchTargetBuffer : public BranchPredictor {
+  public:
+    /* creates an empty buffer of numEntries entries (a power of two)
+     */
+    BranchTargetBuffer(unsigned int numEntries);
+
+    /* returns true if the branch fetched from pc is in the buffer
+     */
+    bool predict(uint32_t pc);
+
+    /* puts the branch fetched from pc into the buffer if it was taken to
+     * target, or takes it out if it was not taken
+     */
+    void update(uint32_t pc, bool taken, uint32_t target);
+
+    /* reads the destination held for the branch fetched from pc into
+     * target; returns false if it is not in the buffer
+     */
+    bool getTarget(uint32_t pc, uint32_t &target);
+
+    /* returns the bytes held by the buffer
+     */
+    size_t getMemoryUsage() const;
+
+  private:
+    unsigned int myMask;           // number of entries - 1
+    vector<uint32_t> myTags;       // address | 1 (valid) of the branch in each entry
+    vector<uint32_t> myTargets;    // and its destination
+};
+
+#endif
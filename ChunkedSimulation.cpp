@@ -0,0 +1,177 @@
+// Name: Maxine Xin
+#include "ChunkedSimulation.h"
+
+#include <thread>
+
+/* numChunks: number of chunks (and threads) to split the instructions into
+ * warmup: number of instructions simulated before the start of each chunk;
+ *         raised to NUMSTAGES if smaller, since a chunk can only be resumed
+ *         from a state whose instructions it holds
+ */
+ChunkedSimulation::ChunkedSimulation(unsigned int numChunks, unsigned int warmup) {
+  myNumChunks = numChunks;
+  if (myNumChunks == 0)
+    myNumChunks = 1;
+  myWarmup = warmup;
+  if (myWarmup < NUMSTAGES)
+    myWarmup = NUMSTAGES;
+  myNumResimulated = 0;
+}
+
+/* simulates the instructions on pipeline, which must already have been
+ * initialized with the same instructions, and stores the execution time
+ * of each instruction into pipeline
+ */
+void ChunkedSimulation::execute(Pipeline *pipeline, const vector<Instruction> &instructions) {
+  unsigned int numInstructions = instructions.size();
+  myChunks.clear();
+  myNumResimulated = 0;
+  if (numInstructions == 0)
+    return;
+
+  // split the instructions into chunks of (almost) equal size
+  unsigned int numChunks = min(myNumChunks, numInstructions);
+  unsigned int begin = 0;
+  for (unsigned int k = 0; k < numChunks; k++) {
+    Chunk chunk;
+    chunk.begin = begin;
+    chunk.end = begin + numInstructions / numChunks;
+    if (k < numInstructions % numChunks)
+      chunk.end++;
+    chunk.base = chunk.begin - min(myWarmup, chunk.begin);
+    chunk.pipeline = pipeline->createEmpty();
+    myChunks.push_back(chunk);
+    begin = chunk.end;
+  }
+
+  // each chunk needs its own copy of the instructions it holds, since
+  // Pipeline::initialize() analyses the dependences among them
+  vector<thread> workers;
+  for (unsigned int k = 0; k < numChunks; k++) {
+    Chunk &chunk = myChunks[k];
+    unsigned int last = min(chunk.end + 1, numInstructions);
+    vector<Instruction> held(instructions.begin() + chunk.base, instructions.begin() + last);
+    chunk.pipeline->initialize(held);
+    workers.push_back(thread(simulateChunk, &chunk, numInstructions));
+  }
+  for (unsigned int k = 0; k < workers.size(); k++) {
+    workers[k].join();
+  }
+
+  // the chunks whose warm-up was not long enough for the pipeline to
+  // converge are simulated again from the state the chunk before them
+  // finished in, all of them at once on their own threads; that changes
+  // their own finish states, so the chunks after them are checked again,
+  // until every chunk starts where the one before it finished (chunk k
+  // does after k rounds at most, usually after one)
+  vector<bool> resimulated(numChunks, false);
+  bool changed = true;
+  while (changed) {
+    // a chunk may change its finish state while the next one starts over
+    vector<PipelineState> finishes(numChunks);
+    for (unsigned int k = 0; k < numChunks; k++) {
+      finishes[k] = myChunks[k].finish;
+    }
+    workers.clear();
+    for (unsigned int k = 1; k < numChunks; k++) {
+      if (!sameStages(finishes[k - 1], myChunks[k].start)) {
+        workers.push_back(thread(resimulateChunk, &myChunks[k], finishes[k - 1], numInstructions));
+        resimulated[k] = true;
+      }
+    }
+    for (unsigned int k = 0; k < workers.size(); k++) {
+      workers[k].join();
+    }
+    changed = !workers.empty();
+  }
+  for (unsigned int k = 0; k < numChunks; k++) {
+    if (resimulated[k])
+      myNumResimulated++;
+  }
+
+  // stitch the chunks together in order; offset converts the times of
+  // the current chunk into the times of a sequential run, the chunk
+  // starting where the one before it finished
+  vector<int> times(numInstructions);
+  int offset = 0;
+  for (unsigned int k = 0; k < numChunks; k++) {
+    Chunk &chunk = myChunks[k];
+    if (k > 0)
+      offset += myChunks[k - 1].finish.time - chunk.start.time;
+
+    const vector<int> &chunkTimes = chunk.pipeline->getExeTimes();
+    for (unsigned int i = chunk.begin; i < chunk.end; i++) {
+      times[i] = chunkTimes[i - chunk.base] + offset;
+    }
+  }
+  pipeline->setExeTimes(times);
+
+  for (unsigned int k = 0; k < numChunks; k++) {
+    delete myChunks[k].pipeline;
+    myChunks[k].pipeline = NULL;
+  }
+}
+
+/* simulates a single chunk from an empty pipeline, recording its start
+ * and finish states; run on its own thread
+ */
+void ChunkedSimulation::simulateChunk(Chunk *chunk, unsigned int numInstructions) {
+  Pipeline *pipeline = chunk->pipeline;
+  PipelineState state = pipeline->run(pipeline->getEmptyState(), chunk->begin - chunk->base);
+  chunk->start = toGlobal(state, chunk->base);
+  if (chunk->end < numInstructions) {
+    state = pipeline->run(state, chunk->end - chunk->base);
+    chunk->finish = toGlobal(state, chunk->base);
+  }
+  // let the rest of the chunk complete
+  pipeline->run(state, pipeline->getNumInstructions());
+}
+
+/* simulates chunk again, starting from state from (global numbers, and
+ * times of the chunk before it); run on its own thread
+ */
+void ChunkedSimulation::resimulateChunk(Chunk *chunk, const PipelineState &from,
+                                        unsigned int numInstructions) {
+  Pipeline *pipeline = chunk->pipeline;
+  PipelineState state = toLocal(from, chunk->base);
+  chunk->start = from;
+  if (chunk->end < numInstructions) {
+    state = pipeline->run(state, chunk->end - chunk->base);
+    chunk->finish = toGlobal(state, chunk->base);
+  }
+  pipeline->run(state, pipeline->getNumInstructions());
+}
+
+/* converts the instruction numbers of state from numbers local to a chunk
+ * whose pipeline starts at instruction base into global numbers
+ */
+PipelineState ChunkedSimulation::toGlobal(PipelineState state, unsigned int base) {
+  for (int st = 0; st < NUMSTAGES; st++) {
+    if (state.stageEntry[st] != -1)
+      state.stageEntry[st] += base;
+  }
+  state.nextFetch += base;
+  return state;
+}
+
+/* converts the instruction numbers of state from global numbers into
+ * numbers local to a chunk whose pipeline starts at instruction base
+ */
+PipelineState ChunkedSimulation::toLocal(PipelineState state, unsigned int base) {
+  for (int st = 0; st < NUMSTAGES; st++) {
+    if (state.stageEntry[st] != -1)
+      state.stageEntry[st] -= base;
+  }
+  state.nextFetch -= base;
+  return state;
+}
+
+/* returns true if both states have the same instructions in each stage
+ */
+bool ChunkedSimulation::sameStages(const PipelineState &s1, const PipelineState &s2) {
+  for (int st = 0; st < NUMSTAGES; st++) {
+    if (s1.stageEntry[st] != s2.stageEntry[st])
+      return false;
+  }
+  return s1.nextFetch == s2.nextFetch;
+}
@@ -0,0 +1,93 @@
+// Name: Maxine Xin
+#ifndef __CHUNKEDSIMULATION_H__
+#define __CHUNKEDSIMULATION_H__
+
+#include <vector>
+
+#include "Pipeline.h"
+
+using namespace std;
+
+/* This class simulates one list of instructions on a Pipeline by splitting
+ * it into chunks, each of which is simulated on its own thread by a fresh
+ * pipeline of the same kind. Since a hazard only involves instructions that
+ * are in the pipeline at the same time, each chunk is started a few
+ * instructions early (the warm-up) from an empty pipeline, which is usually
+ * enough for the pipeline to reach the same state it would have reached
+ * in a sequential run.
+ *
+ * The chunks are then stitched together in order: the state of chunk k when
+ * its first instruction is fetched is compared with the state chunk k - 1
+ * reached when it fetched that same instruction. If they match, the times
+ * of chunk k only need to be shifted; otherwise chunk k is simulated again
+ * starting from the state chunk k - 1 reached, on its own thread as well,
+ * together with the other chunks that did not converge (and, in the rounds
+ * after, the ones after a chunk simulated again). Either way, the result is
+ * the same as the one of Pipeline::execute().
+ */
+class ChunkedSimulation {
+  public:
+    /* numChunks: number of chunks (and threads) to split the instructions into
+     * warmup: number of instructions simulated before the start of each chunk;
+     *         raised to NUMSTAGES if smaller, since a chunk can only be resumed
+     *         from a state whose instructions it holds
+     */
+    ChunkedSimulation(unsigned int numChunks, unsigned int warmup = 2 * NUMSTAGES);
+
+    /* simulates the instructions on pipeline, which must already have been
+     * initialized with the same instructions, and stores the execution time
+     * of each instruction into pipeline
+     */
+    void execute(Pipeline *pipeline, const vector<Instruction> &instructions);
+
+    /* returns the number of chunks simulated by the last call to execute()
+     */
+    unsigned int getNumChunks() { return myChunks.size(); };
+
+    /* returns the number of chunks whose pipeline state had not converged at
+     * their first instruction in the last call to execute(), and thus had to
+     * be simulated again
+     */
+    unsigned int getNumResimulated() { return myNumResimulated; };
+
+  private:
+    // A chunk covers the instructions [begin, end); its pipeline holds the
+    // instructions [base, end], i.e. the warm-up, the chunk itself, and the
+    // first instruction of the next chunk (if any), whose fetch ends the chunk
+    struct Chunk {
+      unsigned int base;
+      unsigned int begin;
+      unsigned int end;
+      Pipeline *pipeline;
+      PipelineState start;    // state once inst begin is fetched (global numbers)
+      PipelineState finish;   // state once inst end is fetched (global numbers)
+    };
+
+    /* simulates a single chunk from an empty pipeline, recording its start
+     * and finish states; run on its own thread
+     */
+    static void simulateChunk(Chunk *chunk, unsigned int numInstructions);
+
+    /* simulates chunk again, starting from state from (global numbers, and
+     * times of the chunk before it); run on its own thread
+     */
+    static void resimulateChunk(Chunk *chunk, const PipelineState &from,
+                                unsigned int numInstructions);
+
+    /* converts the instruction numbers of state between global numbers and
+     * numbers local to a chunk whose pipeline starts at instruction base
+     */
+    static PipelineState toGlobal(PipelineState state, unsigned int base);
+    static PipelineState toLocal(PipelineState state, unsigned int base);
+
+    /* returns true if both states have the same instructions in each stage
+     */
+    static bool sameStages(const PipelineState &s1, const PipelineState &s2);
+
+    unsigned int myNumChunks;
+    unsigned int myWarmup;
+    unsigned int myNumResimulated;
+    vector<Chunk> myChunks;
+};
+
+#endif
@@ -0,0 +1,155 @@
+// Name: Maxine Xin
+#include "DataCache.h"
+
+#include <cstdlib>
+#include <sstream>
+
+#include "MemoryAccount.h"
+
+// the most ways of a set, one per bit of the mask of the ways that match
+static const unsigned int MAXASSOCIATIVITY = 64;
+
+/* creates an empty cache with config, in front of next (not owned), or
+ * of a memory taking memoryLatency cycles if next is NULL
+ */
+DataCache::DataCache(const CacheConfig &config, DataCache *next, unsigned int memoryLatency)
+  : myRandom(1) {
+  myConfig = config;
+  myNext = next;
+  myMemoryLatency = memoryLatency;
+  myLineBits = 0;
+  while ((1u << myLineBits) < myConfig.lineSize) {
+    myLineBits++;
+  }
+  myNumSets = myConfig.size / ((size_t)myConfig.associativity << myLineBits);
+  if (myNumSets == 0)
+    myNumSets = 1;
+  myTags.assign(myNumSets * myConfig.associativity, 0);
+  myStamps.assign(myNumSets * myConfig.associativity, 0);
+  reset();
+}
+
+/* returns the cycles it takes to read the byte at address, and updates
+ * the cache (and the levels below it) as the access does
+ */
+unsigned int DataCache::access(uint32_t address) {
+  uint32_t line = address >> myLineBits;
+  unsigned int set = line % myNumSets;
+  uint32_t tag = (line << 1) | 1;
+  unsigned int ways = myConfig.associativity;
+  unsigned int first = set * ways;
+  const uint32_t *tags = &myTags[first];
+  myNumAccesses++;
+  myClock++;
+
+  // compare every way, without a branch
+  uint64_t match = 0;
+  for (unsigned int w = 0; w < ways; w++) {
+    match |= (uint64_t)(tags[w] == tag) << w;
+  }
+  if (match != 0) {
+    if (myConfig.policy == REPLACE_LRU)
+      myStamps[first + __builtin_ctzll(match)] = myClock;
+    return myConfig.hitLatency;
+  }
+
+  myNumMisses++;
+  unsigned int way = getVictim(set);
+  myTags[first + way] = tag;
+  myStamps[first + way] = myClock;
+  unsigned int below = (myNext != NULL) ? myNext->access(address) : myMemoryLatency;
+  return myConfig.hitLatency + below;
+}
+
+/* empties the cache (not the levels below it) and its counters
+ */
+void DataCache::reset() {
+  myTags.assign(myTags.size(), 0);
+  myStamps.assign(myStamps.size(), 0);
+  myClock = 0;
+  myRandom.seed(1);
+  myNumAccesses = 0;
+  myNumMisses = 0;
+}
+
+/* returns the number of accesses and misses since the last reset(), the
+ * fraction of accesses that hit, and the misses per 1000 of
+ * numInstructions
+ */
+double DataCache::getHitRate() {
+  if (myNumAccesses == 0)
+    return 0;
+  return 1 - (double)myNumMisses / myNumAccesses;
+}
+
+double DataCache::getMPKI(unsigned long long numInstructions) {
+  if (numInstructions == 0)
+    return 0;
+  return 1000.0 * myNumMisses / numInstructions;
+}
+
+/* writes the counters of the cache to out, as a line starting with name
+ */
+void DataCache::write(ostream &out, const string &name, unsigned long long numInstructions) {
+  out << name << ": " << myNumAccesses << " accesses, " << myNumMisses << " misses, hit rate "
+      << getHitRate() * 100 << "%, " << getMPKI(numInstructions) << " MPKI" << endl;
+}
+
+/* returns the bytes held by the cache (not the levels below it)
+ */
+size_t DataCache::getMemoryUsage() const {
+  return sizeof(*this) + MemoryAccount::vectorBytes(myTags) + MemoryAccount::vectorBytes(myStamps);
+}
+
+/* reads config from a list of size (with an optional k, m or g suffix),
+ * associativity, line size, policy (lru, fifo or random) and hit
+ * latency, e.g. 32k,4,64,lru,1; returns false if list cannot be read or
+ * is not a valid cache
+ */
+bool DataCache::parseConfig(const string &list, CacheConfig &config) {
+  stringstream ss(list);
+  vector<string> items;
+  string item;
+  while (getline(ss, item, ',')) {
+    items.push_back(item);
+  }
+  if (items.size() != 5 || !MemoryAccount::parseSize(items[0], config.size))
+    return false;
+  config.associativity = atoi(items[1].c_str());
+  config.lineSize = atoi(items[2].c_str());
+  if (items[3] == "lru")
+    config.policy = REPLACE_LRU;
+  else if (items[3] == "fifo")
+    config.policy = REPLACE_FIFO;
+  else if (items[3] == "random")
+    config.policy = REPLACE_RANDOM;
+  else
+    return false;
+  config.hitLatency = atoi(items[4].c_str());
+
+  // a line holds at least 4 bytes, and a set at least one line
+  bool powerOfTwo = config.lineSize >= 4 && (config.lineSize & (config.lineSize - 1)) == 0;
+  return powerOfTwo && config.associativity >= 1 && config.associativity <= MAXASSOCIATIVITY
+    && config.size >= (size_t)config.associativity * config.lineSize && config.hitLatency >= 1;
+}
+
+/* returns the way of the line to replace in set
+ */
+unsigned int DataCache::getVictim(unsigned int set) {
+  unsigned int ways = myConfig.associativity;
+  unsigned int first = set * ways;
+  // an invalid line first, whose stamp is 0, then by policy
+  if (myConfig.policy == REPLACE_RANDOM) {
+    for (unsigned int w = 0; w < ways; w++) {
+      if (myTags[first + w] == 0)
+        return w;
+    }
+    return uniform_int_distribution<unsigned int>(0, ways - 1)(myRandom);
+  }
+  unsigned int victim = 0;
+  for (unsigned int w = 1; w < ways; w++) {
+    if (myStamps[first + w] < myStamps[first + victim])
+      victim = w;
+  }
+  return victim;
+}
@@ -0,0 +1,109 @@
+// Name: Maxine Xin
+#ifndef __DATACACHE_H__
+#define __DATACACHE_H__
+
+#include <stdint.h>
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// which line of a set a DataCache replaces on a miss
+enum ReplacementPolicy {
+  REPLACE_LRU,        // the least recently used
+  REPLACE_FIFO,       // the one filled first
+  REPLACE_RANDOM      // any of them, at random
+};
+
+// the geometry and hit latency of a DataCache
+struct CacheConfig {
+  size_t size;                  // bytes
+  unsigned int associativity;   // lines per set
+  unsigned int lineSize;        // bytes per line, a power of two
+  ReplacementPolicy policy;
+  unsigned int hitLatency;      // cycles of a hit
+};
+
+/* This class models one level of a set-associative cache (of data, or of
+ * instructions for the I-cache), and what is below it: the next level, if any, or the memory, with a fixed
+ * latency. Each access returns the cycles it takes (the hit latency of each
+ * level down to the one that hits, or the memory latency after the last
+ * one), and fills the line into every level it missed in.
+ *
+ * The tags of a set are kept next to each other, with a valid bit, so that
+ * a lookup compares all of them in a loop without branches (which the
+ * compiler turns into vector compares), and builds the mask of the ways
+ * that match.
+ */
+class DataCache {
+  public:
+    /* creates an empty cache with config, in front of next (not owned), or
+     * of a memory taking memoryLatency cycles if next is NULL
+     */
+    DataCache(const CacheConfig &config, DataCache *next = NULL,
+              unsigned int memoryLatency = 100);
+
+    /* destructor
+     */
+    ~DataCache() {};
+
+    /* returns the cycles it takes to read the byte at address, and updates
+     * the cache (and the levels below it) as the access does
+     */
+    unsigned int access(uint32_t address);
+
+    /* empties the cache (not the levels below it) and its counters
+     */
+    void reset();
+
+    /* returns the number of accesses and misses since the last reset(), the
+     * fraction of accesses that hit, and the misses per 1000 of
+     * numInstructions
+     */
+    long long getNumAccesses() { return myNumAccesses; };
+    long long getNumMisses() { return myNumMisses; };
+    double getHitRate();
+    double getMPKI(unsigned long long numInstructions);
+
+    /* returns the cycles of a hit
+     */
+    unsigned int getHitLatency() { return myConfig.hitLatency; };
+
+    /* writes the counters of the cache to out, as a line starting with name
+     */
+    void write(ostream &out, const string &name, unsigned long long numInstructions);
+
+    /* returns the bytes held by the cache (not the levels below it)
+     */
+    size_t getMemoryUsage() const;
+
+    /* reads config from a list of size (with an optional k, m or g suffix),
+     * associativity, line size, policy (lru, fifo or random) and hit
+     * latency, e.g. 32k,4,64,lru,1; returns false if list cannot be read or
+     * is not a valid cache
+     */
+    static bool parseConfig(const string &list, CacheConfig &config);
+
+  private:
+    /* returns the way of the line to replace in set
+     */
+    unsigned int getVictim(unsigned int set);
+
+    CacheConfig myConfig;
+    DataCache *myNext;
+    unsigned int myMemoryLatency;
+    unsigned int myNumSets;
+    unsigned int myLineBits;           // log2 of the line size
+    vector<uint32_t> myTags;           // (tag << 1) | valid of way w of set s at
+    vector<uint32_t> myStamps;         // s * associativity + w, and when it was
+                                       // last used (LRU) or filled (FIFO)
+    uint32_t myClock;                  // number of accesses, to stamp them
+    mt19937 myRandom;
+    long long myNumAccesses;
+    long long myNumMisses;
+};
+
+#endif
@@ -0,0 +1,140 @@
+// Name: Maxine Xin
+#include "DependenceGraph.h"
+
+#include <algorithm>
+
+/* default constructor, empty graph
+ */
+DependenceGraph::DependenceGraph() {
+  myOffsets.assign(1, 0);
+  myNumCriticalLoadOrMultiply = 0;
+}
+
+/* finds the dependences of the instructions, and builds the graph
+ */
+void DependenceGraph::build(const vector<Instruction> &instructions) {
+  unsigned int numInstructions = instructions.size();
+  DependencyChecker depChecker;
+  OpcodeTable opcodeTable;
+  myIsLoadOrMultiply.assign(numInstructions, false);
+  for (unsigned int i = 0; i < numInstructions; i++) {
+    depChecker.addInstruction(instructions[i]);
+    Opcode op = instructions[i].getOpcode();
+    myIsLoadOrMultiply[i] = opcodeTable.isIMMMemory(op) || op == MULT || op == MFLO;
+  }
+
+  // the DependencyChecker only reports a RAW dependence for the first read
+  // of a register after it is written, so each register read gets an edge
+  // from the last instruction that wrote it instead, which the reads after
+  // it do not change; the WAR and WAW edges are the ones reported, which
+  // come in the order of the later instruction
+  const list<Dependence> &dependences = depChecker.getDependences();
+  list<Dependence>::const_iterator it = dependences.begin();
+  vector<int> lastWriter(DependencyChecker::REG_LO + 1, -1);
+  myOffsets.assign(numInstructions + 1, 0);
+  mySources.clear();
+  myTypes.clear();
+  myRegisters.clear();
+  mySources.reserve(dependences.size());
+  myTypes.reserve(dependences.size());
+  myRegisters.reserve(dependences.size());
+  for (unsigned int i = 0; i < numInstructions; i++) {
+    RegisterAccesses accesses = depChecker.getAccesses(instructions[i]);
+    for (int r = 0; r < accesses.numReads; r++) {
+      unsigned int reg = accesses.reads[r];
+      // a register read twice (e.g. add $1, $2, $2) is one edge
+      bool readBefore = false;
+      for (int before = 0; before < r; before++) {
+        readBefore = readBefore || accesses.reads[before] == reg;
+      }
+      if (lastWriter[reg] != -1 && !readBefore) {
+        mySources.push_back(lastWriter[reg]);
+        myTypes.push_back(RAW);
+        myRegisters.push_back(reg);
+      }
+    }
+    for (int w = 0; w < accesses.numWrites; w++) {
+      lastWriter[accesses.writes[w]] = i;
+    }
+    for (; it != dependences.end() && it -> currentInstructionNumber == (int)i; it++) {
+      if (it -> dependenceType != RAW) {
+        mySources.push_back(it -> previousInstructionNumber);
+        myTypes.push_back(it -> dependenceType);
+        myRegisters.push_back(it -> registerNumber);
+      }
+    }
+    myOffsets[i + 1] = mySources.size();
+  }
+
+  // length of the longest RAW chain ending with each instruction, and the
+  // instruction before it on that chain
+  vector<int> depth(numInstructions, 1);
+  vector<int> previous(numInstructions, -1);
+  int last = -1;
+  for (unsigned int i = 0; i < numInstructions; i++) {
+    for (unsigned int e = myOffsets[i]; e < myOffsets[i + 1]; e++) {
+      if (myTypes[e] == RAW && depth[mySources[e]] + 1 > depth[i]) {
+        depth[i] = depth[mySources[e]] + 1;
+        previous[i] = mySources[e];
+      }
+    }
+    if (last == -1 || depth[i] > depth[last])
+      last = i;
+  }
+
+  myCriticalPath.clear();
+  myNumCriticalLoadOrMultiply = 0;
+  for (int i = last; i != -1; i = previous[i]) {
+    myCriticalPath.push_back(i);
+    if (previous[i] != -1 && (myIsLoadOrMultiply[i] || myIsLoadOrMultiply[previous[i]]))
+      myNumCriticalLoadOrMultiply++;
+  }
+  reverse(myCriticalPath.begin(), myCriticalPath.end());
+}
+
+/* writes the graph out as text: the number of instructions and of edges,
+ * the offsets on one line, then one line per edge with the earlier
+ * instruction, the type (RAW, WAR or WAW) and the register
+ */
+void DependenceGraph::write(ostream &out) {
+  static const char *typeNames[] = { "RAW", "WAR", "WAW" };
+  out << getNumInstructions() << " " << getNumEdges() << "\n";
+  for (unsigned int i = 0; i < myOffsets.size(); i++) {
+    out << (i == 0 ? "" : " ") << myOffsets[i];
+  }
+  out << "\n";
+  for (unsigned int e = 0; e < mySources.size(); e++) {
+    out << mySources[e] << " " << typeNames[myTypes[e]] << " " << (int)myRegisters[e] << "\n";
+  }
+}
+
+/* returns the available ILP with no limit on the instructions in flight
+ */
+double DependenceGraph::getILP() {
+  if (myCriticalPath.empty())
+    return 0;
+  return (double)getNumInstructions() / myCriticalPath.size();
+}
+
+/* returns the available ILP with a window of window instructions
+ */
+double DependenceGraph::getILP(unsigned int window) {
+  unsigned int numInstructions = getNumInstructions();
+  if (numInstructions == 0 || window == 0)
+    return 0;
+
+  // cycle each instruction is done in, and cycle every instruction up to
+  // it is done in
+  vector<int> done(numInstructions, 0);
+  vector<int> allDone(numInstructions, 0);
+  for (unsigned int i = 0; i < numInstructions; i++) {
+    int start = (i >= window) ? allDone[i - window] : 0;
+    for (unsigned int e = myOffsets[i]; e < myOffsets[i + 1]; e++) {
+      if (myTypes[e] == RAW)
+        start = max(start, done[mySources[e]]);
+    }
+    done[i] = start + 1;
+    allDone[i] = (i == 0) ? done[i] : max(allDone[i - 1], done[i]);
+  }
+  return (double)numInstructions / allDone[numInstructions - 1];
+}
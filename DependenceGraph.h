@@ -0,0 +1,94 @@
+// Name: Maxine Xin
+#ifndef __DEPENDENCEGRAPH_H__
+#define __DEPENDENCEGRAPH_H__
+
+#include <iostream>
+#include <vector>
+
+#include "DependencyChecker.h"
+
+using namespace std;
+
+/* This class holds the dependences (RAW, WAR and WAW) of a list of
+ * instructions as a compact graph in CSR form: the dependences of
+ * instruction i on earlier instructions are the edges myOffsets[i] to
+ * myOffsets[i + 1] - 1, each one with the earlier instruction, the type
+ * and the register. Since an edge always goes back to an earlier
+ * instruction, the analyses below are single passes over the instructions.
+ *
+ * The WAR and WAW edges are the ones a DependencyChecker finds; a RAW edge
+ * goes from the last instruction to write each register read, even if
+ * other instructions read it in between (which the DependencyChecker only
+ * reports for the first of them).
+ *
+ * The analyses only follow RAW edges (WAR and WAW go away with register
+ * renaming), with every instruction taking one cycle once its operands are
+ * ready, which gives the lower bound on the total time of any pipeline:
+ *   - the critical path, i.e. the longest chain of RAW dependences
+ *   - the available ILP, i.e. the number of instructions per cycle on that
+ *     dataflow schedule, with no limit on the instructions in flight, or
+ *     with a window of a given number of instructions (an instruction can
+ *     only start once every instruction at least window before it is done)
+ *   - the fraction of the critical path edges that involve a load (LB) or a
+ *     multiply (MULT / MFLO)
+ */
+class DependenceGraph {
+  public:
+    /* default constructor, empty graph
+     */
+    DependenceGraph();
+
+    /* finds the dependences of the instructions, and builds the graph
+     */
+    void build(const vector<Instruction> &instructions);
+
+    /* returns the number of instructions / of edges
+     */
+    unsigned int getNumInstructions() { return myOffsets.size() - 1; };
+    unsigned int getNumEdges() { return mySources.size(); };
+
+    /* returns the arrays of the graph: the first edge of each instruction
+     * (and the number of edges, last), then for each edge, the earlier
+     * instruction, the type of dependence and the register
+     */
+    const vector<unsigned int> &getOffsets() { return myOffsets; };
+    const vector<int> &getSources() { return mySources; };
+    const vector<unsigned char> &getTypes() { return myTypes; };
+    const vector<unsigned char> &getRegisters() { return myRegisters; };
+
+    /* writes the graph out as text: the number of instructions and of edges,
+     * the offsets on one line, then one line per edge with the earlier
+     * instruction, the type (RAW, WAR or WAW) and the register
+     */
+    void write(ostream &out);
+
+    /* returns the number of instructions on the critical path, and the
+     * instructions themselves, in order
+     */
+    int getCriticalPathLength() { return myCriticalPath.size(); };
+    const vector<int> &getCriticalPath() { return myCriticalPath; };
+
+    /* returns the available ILP with no limit on the instructions in flight
+     */
+    double getILP();
+
+    /* returns the available ILP with a window of window instructions
+     */
+    double getILP(unsigned int window);
+
+    /* returns the number of edges on the critical path that involve a load
+     * or a multiply
+     */
+    int getNumCriticalLoadOrMultiply() { return myNumCriticalLoadOrMultiply; };
+
+  private:
+    vector<unsigned int> myOffsets;
+    vector<int> mySources;
+    vector<unsigned char> myTypes;
+    vector<unsigned char> myRegisters;
+    vector<bool> myIsLoadOrMultiply;   // whether each instruction is a LB, MULT or MFLO
+    vector<int> myCriticalPath;
+    int myNumCriticalLoadOrMultiply;
+};
+
+#endif
@@ -1,8 +1,8 @@
 #include "DependencyChecker.h"
 
 DependencyChecker::DependencyChecker(int numRegisters)
-/* Creates RegisterInfo entries for each of the 32 registers and creates lists for
- * dependencies and instructions.
+/* Creates RegisterInfo entries for each of the 32 registers (and HI and LO) and
+ * creates lists for dependencies and instructions.
  */
 {
   RegisterInfo r;
@@ -11,6 +11,8 @@ DependencyChecker::DependencyChecker(int numRegisters)
   for(int i = 0; i < numRegisters; i++){
     myCurrentState.insert(make_pair(i, r));
   }
+  myCurrentState.insert(make_pair((unsigned int)REG_HI, r));
+  myCurrentState.insert(make_pair((unsigned int)REG_LO, r));
 }
 
 void DependencyChecker::addInstruction(Instruction i)
@@ -20,36 +22,59 @@ void DependencyChecker::addInstruction(Instruction i)
  * are added to the list of dependences.
  */
 {
-  InstType iType = i.getInstType();
+  RegisterAccesses accesses = getAccesses(i);
+  myRAWProducers.push_back(vector<int>());
+  myRAWRegisters.push_back(vector<int>());
+
+  // the registers read are checked before the ones written
+  for (int r = 0; r < accesses.numReads; r++) {
+    checkForReadDependence(accesses.reads[r]);
+  }
+  for (int w = 0; w < accesses.numWrites; w++) {
+    checkForWriteDependence(accesses.writes[w]);
+  }
+
+  // add instruction to Instruction list
+  myInstructions.push_back(i);
+
+}
+
+RegisterAccesses DependencyChecker::getAccesses(const Instruction &i)
+/* Given an instruction i, returns the registers it reads and the ones it
+ * writes, in the order addInstruction() checks them.
+ */
+{
   Opcode op = i.getOpcode();       //get opcode
+  InstType iType = (op == UNDEFINED) ? INVALID : myOpcodeTable.getInstType(op);
+  RegisterAccesses accesses;
+  accesses.numReads = 0;
+  accesses.numWrites = 0;
+
+  // MFLO reads LO, which is not one of its operands
+  if (op == MFLO)
+    accesses.reads[accesses.numReads++] = REG_LO;
 
   switch(iType){
   case RTYPE:
-    // get rs and rt and check Read Dependence if it exists
-    if (myOpcodeTable.RSposition(op) != -1) {
-      unsigned int rs = i.getRS();
-      checkForReadDependence(rs);
-    }
-    if (myOpcodeTable.RTposition(op) != -1) {
-      unsigned int rt = i.getRT();
-      checkForReadDependence(rt);
-    }
-    //get rd and check Write Dependence if it exists
-    if (myOpcodeTable.RDposition(op) != -1) {
-      unsigned int rd = i.getRD();
-      checkForWriteDependence(rd);   
-    }
+    // get rs and rt if they are read
+    if (myOpcodeTable.RSposition(op) != -1)
+      accesses.reads[accesses.numReads++] = i.getRS();
+    if (myOpcodeTable.RTposition(op) != -1)
+      accesses.reads[accesses.numReads++] = i.getRT();
+    //get rd if it is written
+    if (myOpcodeTable.RDposition(op) != -1)
+      accesses.writes[accesses.numWrites++] = i.getRD();
     break;
   case ITYPE:
-    // get rs and check Read Dependence if it exists
-    if (myOpcodeTable.RSposition(op) != -1) {
-      unsigned int rs = i.getRS();
-      checkForReadDependence(rs);
-    }
-    // get rd and check Write Dependence if it exists
+    // get rs if it is read
+    if (myOpcodeTable.RSposition(op) != -1)
+      accesses.reads[accesses.numReads++] = i.getRS();
+    // get rt if it is written (a branch compares it with rs instead)
     if (myOpcodeTable.RTposition(op) != -1) {
-      unsigned int rt = i.getRT();
-      checkForWriteDependence(rt);
+      if (myOpcodeTable.isBranch(op))
+        accesses.reads[accesses.numReads++] = i.getRT();
+      else
+        accesses.writes[accesses.numWrites++] = i.getRT();
     }
     break;
   case JTYPE: 
@@ -60,9 +85,12 @@ void DependencyChecker::addInstruction(Instruction i)
     break;
   }
 
-  // add instruction to Instruction list
-  myInstructions.push_back(i);
-
+  // MULT writes its product to HI and LO instead of an operand
+  if (op == MULT) {
+    accesses.writes[accesses.numWrites++] = REG_HI;
+    accesses.writes[accesses.numWrites++] = REG_LO;
+  }
+  return accesses;
 }
 
 void DependencyChecker::checkForReadDependence(unsigned int reg)
@@ -81,6 +109,8 @@ void DependencyChecker::checkForReadDependence(unsigned int reg)
     dp.previousInstructionNumber = regInfoPrev.lastInstructionToAccess;
     dp.currentInstructionNumber = myInstructions.size();
     myDependences.push_back(dp);
+    myRAWProducers.back().push_back(dp.previousInstructionNumber);
+    myRAWRegisters.back().push_back(reg);
   } 
   // construct a value, and update the value corresponding to the key for 
   // my current state
@@ -130,35 +160,82 @@ bool DependencyChecker::isRAW(int i1Num, int i2Num)
  * Returns true is there is a RAW, and returns false if otherwise.
  */ 
 {
-  // iterate through the list of RAW instructions, return true if find a match,
+  // go through the RAW producers of i2, return true if find a match,
   // otherwise return false
-  list<Dependence>::iterator diter;
-  for (diter = myDependences.begin(); diter != myDependences.end(); diter++) {
-    if ((*diter).dependenceType == RAW              &&
-        (*diter).previousInstructionNumber == i1Num && 
-        (*diter).currentInstructionNumber  == i2Num   ) {
+  if (i2Num < 0 || i2Num >= (int)myRAWProducers.size())
+    return false;
+  vector<int> &producers = myRAWProducers[i2Num];
+  for (unsigned int p = 0; p < producers.size(); p++) {
+    if (producers[p] == i1Num)
       return true;
-    } 
   }
   return false;
 }
 
+int DependencyChecker::getRAWRegister(int i1Num, int i2Num)
+/* Given two instruction numbers i1Num and i2Num, returns the register that i2 reads
+ * from i1 if there is a RAW dependence between them, or -1 if there is none.
+ */ 
+{
+  if (i2Num < 0 || i2Num >= (int)myRAWProducers.size())
+    return -1;
+  vector<int> &producers = myRAWProducers[i2Num];
+  for (unsigned int p = 0; p < producers.size(); p++) {
+    if (producers[p] == i1Num)
+      return myRAWRegisters[i2Num][p];
+  }
+  return -1;
+}
+
+size_t DependencyChecker::getMemoryUsage() const
+/* Returns the bytes held by the dependence checker: the state of each
+ * register, the dependences, the instructions and the RAW producers.
+ */
+{
+  size_t bytes = sizeof(*this);
+  bytes += myCurrentState.size() * (sizeof(pair<unsigned int, RegisterInfo>) + 4 * sizeof(void*));
+  bytes += MemoryAccount::listBytes(myDependences);
+  bytes += MemoryAccount::objectListBytes(myInstructions);
+  bytes += MemoryAccount::vectorBytes(myRAWProducers) + MemoryAccount::vectorBytes(myRAWRegisters);
+  for (unsigned int i = 0; i < myRAWProducers.size(); i++) {
+    bytes += MemoryAccount::vectorBytes(myRAWProducers[i]) 
+      + MemoryAccount::vectorBytes(myRAWRegisters[i]);
+  }
+  return bytes;
+}
+
+string DependencyChecker::getRegisterName(int reg)
+/* Returns the name of register number reg: $reg, or $hi / $lo.
+ */
+{
+  if (reg == REG_HI)
+    return "$hi";
+  if (reg == REG_LO)
+    return "$lo";
+  return "$" + to_string(reg);
+}
+
 void DependencyChecker::printRAWDependences() 
 /* Prints out the RAW dependences followed by the correponding instructions 
  */ 
 { 
+  // look the instructions up by number instead of going through the list
+  vector<list<Instruction>::iterator> insts;
+  insts.reserve(myInstructions.size());
+  list<Instruction>::iterator instIter;
+  for (instIter = myInstructions.begin(); instIter != myInstructions.end(); instIter++) {
+    insts.push_back(instIter);
+  }
+
   list<Dependence>::iterator depIter;
   for (depIter = myDependences.begin(); depIter != myDependences.end(); depIter++) {
     if ((*depIter).dependenceType == RAW) {
       cout << "RAW Dependence between instruction ";
-      list<Instruction>::iterator instIter = myInstructions.begin();
       int i1Num = (*depIter).previousInstructionNumber;
       int i2Num = (*depIter).currentInstructionNumber;
       
-      advance(instIter, i1Num);
-      cout << i1Num << " " << (*instIter).getAssembly() << " and ";
-      advance(instIter, i2Num - i1Num);
-      cout << i2Num << " " << (*instIter).getAssembly() << endl;
+      cout << i1Num << " " << (*insts[i1Num]).getAssembly() << " and ";
+      cout << i2Num << " " << (*insts[i2Num]).getAssembly() << "\n";
     }
 
     // cout << i1Num << " and " << i2Num << endl;
@@ -197,7 +274,7 @@ void DependencyChecker::printDependences()
       break;
     }
 
-    cout << "$" << (*diter).registerNumber << " \t";
+    cout << getRegisterName((*diter).registerNumber) << " \t";
     cout << "(" << (*diter).previousInstructionNumber << ", ";
     cout << (*diter).currentInstructionNumber << ")" << endl;
   }
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <map>
 #include <list>
+#include <vector>
 
 using namespace std;
 
@@ -46,6 +47,17 @@ struct RegisterInfo{
   };
 };
 
+/* RegisterAccesses holds the registers an instruction reads and then the ones
+ * it writes, in the order the dependences are checked: LO (MFLO), rs and rt
+ * are read, then rd or rt, and HI and LO (MULT) are written.
+ */
+struct RegisterAccesses {
+  int numReads;
+  unsigned int reads[3];
+  int numWrites;
+  unsigned int writes[3];
+};
+
 /* The Dependence struct keeps track of the involved instructions, the register
  * that the dependence involves, and what type of dependence.
  */
@@ -60,13 +72,15 @@ struct Dependence {
 /* This class keeps track of a sequence of instructions and determines data
  * dependencies that occur between the instructions due to register usage.  Instructions
  * are numbered and those numbers are used to keep track of which instructions
- * are used in a dependence.
+ * are used in a dependence. Besides the 32 general purpose registers, MULT writes
+ * the HI and LO registers, and MFLO reads LO, so that MFLO depends on the MULT
+ * before it.
  */ 
 class DependencyChecker {
  public:
 
-  /* Creates RegisterInfo entries for each of the 32 registers and creates lists for
-   * dependencies and instructions.
+  /* Creates RegisterInfo entries for each of the 32 registers (and HI and LO) and
+   * creates lists for dependencies and instructions.
    */
   DependencyChecker(int numRegisters = 32);
   
@@ -77,6 +91,11 @@ class DependencyChecker {
    */
   void addInstruction(Instruction i);
 
+  /* Given an instruction i, returns the registers it reads and the ones it
+   * writes, in the order addInstruction() checks them.
+   */
+  RegisterAccesses getAccesses(const Instruction &i);
+
   /* Given two instruction numbers i1Num and i2Num, check whether there is a RAW dependence 
    * between instructions i1 and i2(more specifically, whether the read register of i2 is
    * the same as the write register of i1).
@@ -84,6 +103,21 @@ class DependencyChecker {
    */ 
   bool isRAW(int i1, int i2);
 
+  /* Given two instruction numbers i1Num and i2Num, returns the register that i2 reads
+   * from i1 if there is a RAW dependence between them, or -1 if there is none.
+   */
+  int getRAWRegister(int i1, int i2);
+
+  /* Given an instruction number i, returns the numbers of the instructions
+   * that i has a RAW dependence on (at most one per register read by i).
+   */
+  const vector<int> &getRAWProducers(int i) { return myRAWProducers[i]; };
+
+  /* Returns every dependence found (RAW, WAR and WAW), in the order of the
+   * second instruction involved.
+   */
+  const list<Dependence> &getDependences() { return myDependences; };
+
   /* Prints out the sequence of instructions followed by the sequence of data
    * dependencies.
    */ 
@@ -93,6 +127,19 @@ class DependencyChecker {
    */ 
   void printRAWDependences();
 
+  /* Returns the bytes held by the dependence checker: the state of each
+   * register, the dependences, the instructions and the RAW producers.
+   */
+  size_t getMemoryUsage() const;
+
+  /* Returns the name of register number reg: $reg, or $hi / $lo.
+   */
+  static string getRegisterName(int reg);
+
+  // the numbers of the HI and LO registers, after the general purpose ones
+  const static int REG_HI = 32;
+  const static int REG_LO = 33;
+
  private:
   /* Determines if a read data dependence occurs when reg is read by the current
    * instruction.  If so, adds an entry to the list of dependences. Also updates
@@ -109,6 +156,9 @@ class DependencyChecker {
   map<unsigned int, RegisterInfo> myCurrentState;
   list<Dependence> myDependences;
   list<Instruction> myInstructions;
+  vector<vector<int> > myRAWProducers;   // RAW producers of each instruction, so that
+                                         // isRAW() does not go through myDependences
+  vector<vector<int> > myRAWRegisters;   // and the register read from each of them
   OpcodeTable myOpcodeTable;
 };
 
@@ -1,6 +1,13 @@
 // Name: Maxine Xin
 #include "ForwardingPipeline.h"
 
+#include <sstream>
+
+// name of each path in a list, and the path
+static const int NUMPATHS = 3;
+static const char *PATH_NAMES[NUMPATHS] = { "exex", "memex", "wbid" };
+static const int PATHS[NUMPATHS] = { FORWARD_EX_EX, FORWARD_MEM_EX, FORWARD_WB_ID };
+
 /* default constructor of Forwarding Pipeline
  *
  */
@@ -8,6 +15,80 @@ ForwardingPipeline::ForwardingPipeline() : Pipeline() {
   myName = "FORWARDING";
 }
 
+/* returns a newly allocated, uninitialized ForwardingPipeline
+ */
+Pipeline *ForwardingPipeline::createEmpty() {
+  return new ForwardingPipeline();
+}
+
+/* returns the stages that decide when the forwarding pipeline stalls
+ */
+PipelineConfig ForwardingPipeline::getConfig() {
+  PipelineConfig config;
+  config.operandNeeded = MY_STAGE_OPERAND_NEEDED;
+  config.operandProducedMemory = MY_STAGE_OPERAND_PRODUCED_MMR;
+  config.operandProducedOther = MY_STAGE_OPERAND_PRODUCED_NONMMR;
+  config.forwarding = true;
+  config.jumpDestProduced = MY_STAGE_JUMP_DEST_PRODUCED;
+  config.forwardPaths = FORWARD_BY_STAGES;
+  return config;
+}
+
+/* returns the stages of a forwarding pipeline that only forwards the
+ * results along paths (a set of ForwardPath), reading the registers in
+ * DECODE; with ALLFORWARDPATHS, it stalls as long as this one does, and
+ * with FORWARD_WB_ID alone, as long as a StallPipeline
+ */
+PipelineConfig ForwardingPipeline::getPathsConfig(int paths) {
+  PipelineConfig config;
+  config.operandNeeded = DECODE;
+  config.operandProducedMemory = MEMORY;
+  config.operandProducedOther = EXECUTE;
+  config.forwarding = (paths & (FORWARD_EX_EX | FORWARD_MEM_EX)) != 0;
+  config.jumpDestProduced = DECODE;
+  config.forwardPaths = paths;
+  return config;
+}
+
+/* reads paths from a list of exex, memex and wbid (or all, or none),
+ * e.g. exex,wbid; returns false if list cannot be read
+ */
+bool ForwardingPipeline::parsePaths(const string &list, int &paths) {
+  stringstream ss(list);
+  string item;
+  paths = 0;
+  while (getline(ss, item, ',')) {
+    if (item == "all") {
+      paths |= ALLFORWARDPATHS;
+      continue;
+    }
+    if (item == "none")
+      continue;
+    int path = 0;
+    while (path < NUMPATHS && item != PATH_NAMES[path]) {
+      path++;
+    }
+    if (path == NUMPATHS)
+      return false;
+    paths |= PATHS[path];
+  }
+  return true;
+}
+
+/* returns the list of paths, as parsePaths() reads it
+ */
+string ForwardingPipeline::getPathsName(int paths) {
+  string name;
+  for (int path = 0; path < NUMPATHS; path++) {
+    if ((paths & PATHS[path]) == 0)
+      continue;
+    if (name.length() > 0)
+      name += ",";
+    name += PATH_NAMES[path];
+  }
+  return (name.length() > 0) ? name : "none";
+}
+
 /* given a Stage index st, returns true if the instruction in the
  * preceding stage / the instruction to be fetched
  * can be moved into Stage st, returns false if otherwise 
@@ -15,8 +96,10 @@ ForwardingPipeline::ForwardingPipeline() : Pipeline() {
  */
 bool ForwardingPipeline::canMoveIntoStage(int st) {
   // if stage is currently occupied
-  if (myStageEntry[st] != myStageEmpty)
+  if (myStageEntry[st] != myStageEmpty) {
+    myStallCause = STALL_STRUCTURAL;
     return false;
+  }
   
   // if the stage where operand is needed is not the previous stage of
   // the current stage, the current stage should be able to get instruction
@@ -31,14 +114,12 @@ bool ForwardingPipeline::canMoveIntoStage(int st) {
         stAffectedByJump <= MY_STAGE_JUMP_DEST_PRODUCED; stAffectedByJump++) {
         if (myStageEntry[stAffectedByJump] != myStageEmpty) {
           // if myStageEntry[stAffectedByJump] is not empty,
-          // get that instruction
-          list<Instruction>::iterator it = myInstructions.begin();
-          advance(it, myStageEntry[stAffectedByJump]);
-
-          // if that inst is a jump inst, no inst can be fetched,
+          // and that inst is a jump inst, no inst can be fetched,
           // so cannot move into the first stage, return false
-          if (myOpcodeTable.isIMMLabel((*it).getOpcode()))
+          if (myOpcodeTable.isIMMLabel(myOpcodes[myStageEntry[stAffectedByJump]])) {
+            myStallCause = STALL_JUMP;
             return false;
+          }
         }
       }
     }
@@ -62,19 +143,23 @@ bool ForwardingPipeline::canMoveIntoStage(int st) {
         // since stage operand produced for MMR(EXECUTIONs) inst is always later than 
         // stage operand produced for NON_MMR(MEMORYs) inst, and thus there is a stall here regardless,
         // thus cannot move and return false
-        if (influenceSt <= MY_STAGE_OPERAND_PRODUCED_NONMMR + 1)
+        if (influenceSt <= MY_STAGE_OPERAND_PRODUCED_NONMMR + 1) {
+          myStallCause = STALL_RAW;
+          myStallProducer = myStageEntry[influenceSt];
           return false;
+        }
      
         // when program reaches here, we do need to check whether inst in 
         // if the previous inst is a MMR inst, since in stage between after operand for 
         // NON_MMR inst is produced and after operand for MMR inst is produced, only a MMR inst
         // will cause stall
-        list<Instruction>::iterator it = myInstructions.begin();
-        advance(it, myStageEntry[influenceSt]);       // get that inst in influenceSt
-   
-        // if indeed a MMR inst, will have stall, so cannot move and return false 
-        if (myOpcodeTable.isIMMMemory((*it).getOpcode()))
+
+        // if the inst in influenceSt is indeed a MMR inst, will have stall, so cannot move and return false 
+        if (myOpcodeTable.isIMMMemory(myOpcodes[myStageEntry[influenceSt]])) {
+          myStallCause = STALL_RAW;
+          myStallProducer = myStageEntry[influenceSt];
           return false;
+        }
         
       }
     }
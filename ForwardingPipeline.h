@@ -2,8 +2,9 @@
 #ifndef __FORWARDINGPIPELINE_H__
 #define __FORWARDINGPIPELINE_H__
 
-#include "Pipeline.h"
+#include <string>
 
+#include "Pipeline.h"
 
 class ForwardingPipeline : public Pipeline {
   public:
@@ -16,6 +17,30 @@ class ForwardingPipeline : public Pipeline {
      */
     ~ForwardingPipeline() {};
 
+    /* returns a newly allocated, uninitialized ForwardingPipeline
+     */
+    Pipeline *createEmpty();
+
+    /* returns the stages that decide when the forwarding pipeline stalls
+     */
+    PipelineConfig getConfig();
+
+    /* returns the stages of a forwarding pipeline that only forwards the
+     * results along paths (a set of ForwardPath), reading the registers in
+     * DECODE; with ALLFORWARDPATHS, it stalls as long as this one does, and
+     * with FORWARD_WB_ID alone, as long as a StallPipeline
+     */
+    static PipelineConfig getPathsConfig(int paths);
+
+    /* reads paths from a list of exex, memex and wbid (or all, or none),
+     * e.g. exex,wbid; returns false if list cannot be read
+     */
+    static bool parsePaths(const string &list, int &paths);
+
+    /* returns the list of paths, as parsePaths() reads it
+     */
+    static string getPathsName(int paths);
+
   private:
     /* given a Stage index st, returns true if the instruction in the
      * preceding stage / the instruction to be fetched 
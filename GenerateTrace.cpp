@@ -0,0 +1,83 @@
+// Name: Maxine Xin
+#include "WorkloadGenerator.h"
+
+#include <cstdlib>
+#include <iostream>
+using namespace std;
+
+/* This file writes a synthetic list of instructions to stdout, as MIPS
+ * assembly instructions (or as their binary encodings), which PIPESIM can
+ * read back as a .asm (or .mach) file. The same options and seed always
+ * give the same instructions.
+ *
+ * usage: GENTRACE <numInstructions> [-seed X] [-mix M] [-loads F] [-jumps F]
+ *                                   [-raw R] [-binary]
+ *   -seed X: seed of the random instructions (default 1)
+ *   -mix M: weight of each opcode, e.g. add=2,xor=1,lb=1 (default all
+ *           opcodes but j and beq, equally; beq is generated
+ *           without an outcome, so taken as not taken)
+ *   -loads F: fraction F of the instructions are loads (lb)
+ *   -jumps F: fraction F of the instructions are jumps (j)
+ *   -raw R: weight of each RAW distance from 0 (no dependence), e.g.
+ *           2,1,1 for half with no dependence, a quarter on the previous
+ *           instruction and a quarter on the one before (default 1: none)
+ *   -binary: writes binary encodings instead of assembly
+ *
+ */
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    cerr << "Need to specify the number of instructions to generate." << endl;
+    exit(1);
+  }
+
+  unsigned long long numInstructions = strtoull(argv[1], NULL, 10);
+  unsigned int seed = 1;
+  string mix;
+  string raw;
+  double loads = -1;
+  double jumps = -1;
+  bool binary = false;
+
+  for (int arg = 2; arg < argc; arg++) {
+    string option = argv[arg];
+    if (option == "-seed" && arg + 1 < argc) {
+      seed = atoi(argv[++arg]);
+    } else if (option == "-mix" && arg + 1 < argc) {
+      mix = argv[++arg];
+    } else if (option == "-loads" && arg + 1 < argc) {
+      loads = atof(argv[++arg]);
+    } else if (option == "-jumps" && arg + 1 < argc) {
+      jumps = atof(argv[++arg]);
+    } else if (option == "-raw" && arg + 1 < argc) {
+      raw = argv[++arg];
+    } else if (option == "-binary") {
+      binary = true;
+    } else {
+      cerr << "Unknown option " << option << endl;
+      exit(1);
+    }
+  }
+
+  WorkloadGenerator generator(seed);
+  if (mix.length() > 0 && !generator.setOpcodeMix(mix)) {
+    cerr << "Cannot read opcode mix " << mix << endl;
+    exit(1);
+  }
+  if (raw.length() > 0 && !generator.setRAWDistances(raw)) {
+    cerr << "Cannot read RAW distances " << raw << endl;
+    exit(1);
+  }
+  if (loads + jumps > 1) {
+    cerr << "-loads and -jumps add up to more than 1." << endl;
+    exit(1);
+  }
+  generator.setLoadFraction(loads);
+  generator.setJumpFraction(jumps);
+
+  if (!generator.write(cout, numInstructions, binary)) {
+    cerr << "Cannot write the instructions." << endl;
+    exit(1);
+  }
+  return(0);
+}
@@ -0,0 +1,26 @@
+// Name: Maxine Xin
+#include "GsharePredictor.h"
+
+/* creates a predictor of numEntries counters (a power of two) and
+ * historyBits bits of history
+ */
+GsharePredictor::GsharePredictor(unsigned int numEntries, unsigned int historyBits)
+  : BimodalPredictor(numEntries) {
+  myName = "gshare";
+  myHistory = 0;
+  myHistoryMask = ((uint32_t)1 << historyBits) - 1;
+}
+
+/* learns that the branch fetched from pc was taken to target, or not
+ * taken, and shifts its outcome into the history
+ */
+void GsharePredictor::update(uint32_t pc, bool taken, uint32_t target) {
+  BimodalPredictor::update(pc, taken, target);
+  myHistory = ((myHistory << 1) | (taken ? 1 : 0)) & myHistoryMask;
+}
+
+/* returns the counter the branch fetched from pc is predicted by
+ */
+unsigned int GsharePredictor::getIndex(uint32_t pc) {
+  return ((pc >> 2) ^ myHistory) & myMask;
+}
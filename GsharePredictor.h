@@ -0,0 +1,35 @@
+// Name: Maxine Xin
+#ifndef __GSHAREPREDICTOR_H__
+#define __GSHAREPREDICTOR_H__
+
+#include "BimodalPredictor.h"
+
+/* This class predicts each branch with 2-bit counters as a
+ * BimodalPredictor does, but picks the counter by the address of the
+ * branch XORed with the global history, the outcomes of the last H
+ * branches (the latest in the lowest bit), so that a branch is predicted
+ * by the path that led to it.
+ */
+class GsharePredictor : public BimodalPredictor {
+  public:
+    /* creates a predictor of numEntries counters (a power of two) and
+     * historyBits bits of history
+     */
+    GsharePredictor(unsigned int numEntries, unsigned int historyBits);
+
+    /* learns that the branch fetched from pc was taken to target, or not
+     * taken, and shifts its outcome into the history
+     */
+    void update(uint32_t pc, bool taken, uint32_t target);
+
+  protected:
+    /* returns the counter the branch fetched from pc is predicted by
+     */
+    unsigned int getIndex(uint32_t pc);
+
+  private:
+    uint32_t myHistory;
+    uint32_t myHistoryMask;
+};
+
+#endif
@@ -0,0 +1,217 @@
+// Name: Maxine Xin
+#include "IncrementalSimulation.h"
+
+#include <algorithm>
+
+/* kind: a pipeline of the kind to simulate; it is only used to create
+ *       other pipelines of the same kind
+ */
+IncrementalSimulation::IncrementalSimulation(Pipeline *kind) {
+  myKind = kind;
+  myNumResimulated = 0;
+}
+
+/* stores and simulates the instructions
+ */
+void IncrementalSimulation::load(const vector<Instruction> &instructions) {
+  myInstructions = instructions;
+  unsigned int numInstructions = instructions.size();
+  myFetchTimes.assign(numInstructions, 0);
+  myFetchStages.assign(numInstructions * NUMSTAGES, 0);
+
+  Pipeline *pipeline = myKind->createEmpty();
+  pipeline->initialize(myInstructions);
+
+  // fetch the instructions one at a time to record the states in between
+  PipelineState state = pipeline->getEmptyState();
+  for (unsigned int i = 0; i < numInstructions; i++) {
+    state = pipeline->run(state, i);
+    setFetchState(myFetchStages, myFetchTimes, i, state);
+  }
+  pipeline->run(state, numInstructions);
+
+  myExeTimes = pipeline->getExeTimes();
+  myNumResimulated = numInstructions;
+  delete pipeline;
+}
+
+/* inserts instruction i before the instruction at index k (at the end
+ * if k is the number of instructions), and updates the execution times;
+ * returns false if k is out of range
+ */
+bool IncrementalSimulation::insertInstruction(unsigned int k, const Instruction &i) {
+  if (k > myInstructions.size())
+    return false;
+  myInstructions.insert(myInstructions.begin() + k, i);
+  resimulate(k, k + 1, -1);
+  return true;
+}
+
+/* deletes the instruction at index k, and updates the execution times;
+ * returns false if k is out of range
+ */
+bool IncrementalSimulation::deleteInstruction(unsigned int k) {
+  if (k >= myInstructions.size())
+    return false;
+  myInstructions.erase(myInstructions.begin() + k);
+  resimulate(k, k, 1);
+  return true;
+}
+
+/* replaces the instruction at index k by i, and updates the execution times;
+ * returns false if k is out of range
+ */
+bool IncrementalSimulation::replaceInstruction(unsigned int k, const Instruction &i) {
+  if (k >= myInstructions.size())
+    return false;
+  myInstructions[k] = i;
+  resimulate(k, k + 1, 0);
+  return true;
+}
+
+/* returns the execution time of the last instruction, 0 if there is none
+ */
+int IncrementalSimulation::getTotalTime() {
+  if (myExeTimes.empty())
+    return 0;
+  return myExeTimes.back();
+}
+
+/* simulates again after an edit at index k; the instructions from index
+ * firstUnchanged on were at index + shift in the previous run
+ */
+void IncrementalSimulation::resimulate(unsigned int k, unsigned int firstUnchanged, int shift) {
+  unsigned int numInstructions = myInstructions.size();
+  unsigned int oldNumInstructions = myFetchTimes.size();
+
+  // the instructions before k are not affected, so start from the state
+  // right after k - 1 was fetched
+  PipelineState start;
+  if (k > 0) {
+    start = getFetchState(k - 1);
+  } else {
+    for (int st = 0; st < NUMSTAGES; st++) {
+      start.stageEntry[st] = -1;
+    }
+    start.time = 0;
+    start.nextFetch = 0;
+  }
+  unsigned int oldest = start.nextFetch;      // next inst to complete
+  for (int st = 0; st < NUMSTAGES; st++) {
+    if (start.stageEntry[st] != -1)
+      oldest = min(oldest, (unsigned int)start.stageEntry[st]);
+  }
+
+  // the pipeline only holds the instructions [base, end); the ones in the
+  // pipeline at the start need to be there, with the dependences among them
+  unsigned int base = oldest;
+  unsigned int end = min(numInstructions, k + WINDOW);
+  vector<unsigned char> stages;
+  vector<int> times;
+  vector<int> completed;
+  PipelineState global;
+  bool converged = false;
+  unsigned int j = k;
+
+  while (true) {
+    Pipeline *pipeline = myKind->createEmpty();
+    pipeline->initialize(vector<Instruction>(myInstructions.begin() + base,
+                                             myInstructions.begin() + end));
+    PipelineState local = start;
+    for (int st = 0; st < NUMSTAGES; st++) {
+      if (local.stageEntry[st] != -1)
+        local.stageEntry[st] -= base;
+    }
+    local.nextFetch -= base;
+
+    stages.assign((end - k) * NUMSTAGES, 0);
+    times.assign(end - k, 0);
+    completed.clear();
+    for (j = k; j < end; j++) {
+      local = pipeline->run(local, j - base, &completed);
+      global = local;
+      for (int st = 0; st < NUMSTAGES; st++) {
+        if (global.stageEntry[st] != -1)
+          global.stageEntry[st] += base;
+      }
+      global.nextFetch += base;
+      setFetchState(stages, times, j - k, global);
+
+      // once none of the edited instructions is in the pipeline, and it is
+      // in the same state as in the previous run, the rest is the same
+      int oldJ = j + shift;
+      if (j >= firstUnchanged + NUMSTAGES - 1 && oldJ < (int)oldNumInstructions &&
+          equal(stages.begin() + (j - k) * NUMSTAGES, stages.begin() + (j - k + 1) * NUMSTAGES,
+                myFetchStages.begin() + oldJ * NUMSTAGES)) {
+        converged = true;
+        break;
+      }
+    }
+
+    if (!converged && end == numInstructions) {
+      // no more instructions, let the pipeline drain
+      pipeline->run(local, pipeline->getNumInstructions(), &completed);
+    }
+    delete pipeline;
+    if (converged || end == numInstructions)
+      break;
+    // not enough instructions to get back to the previous run, try again
+    // with twice as many
+    end = min(numInstructions, base + 2 * (end - base));
+  }
+
+  // put together the execution times: unchanged before oldest, simulated
+  // again from there, and shifted from the previous run after that
+  vector<int> exeTimes(myExeTimes.begin(), myExeTimes.begin() + oldest);
+  exeTimes.insert(exeTimes.end(), completed.begin(), completed.end());
+  unsigned int numFetched = end - k;
+  if (converged) {
+    numFetched = j - k + 1;
+    int offset = global.time - myFetchTimes[j + shift];
+    for (unsigned int x = exeTimes.size(); x < numInstructions; x++) {
+      exeTimes.push_back(myExeTimes[x + shift] + offset);
+    }
+
+    // and the same for the states after each fetch
+    times.resize(numFetched);
+    for (unsigned int x = j + 1; x < numInstructions; x++) {
+      times.push_back(myFetchTimes[x + shift] + offset);
+    }
+    stages.resize(numFetched * NUMSTAGES);
+    stages.insert(stages.end(), myFetchStages.begin() + (j + 1 + shift) * NUMSTAGES,
+                  myFetchStages.end());
+  }
+
+  myFetchTimes.resize(k);
+  myFetchTimes.insert(myFetchTimes.end(), times.begin(), times.end());
+  myFetchStages.resize(k * NUMSTAGES);
+  myFetchStages.insert(myFetchStages.end(), stages.begin(), stages.end());
+  myExeTimes.swap(exeTimes);
+  myNumResimulated = numFetched;
+}
+
+/* returns the stored state right after instruction i was fetched
+ */
+PipelineState IncrementalSimulation::getFetchState(int i) {
+  PipelineState state;
+  for (int st = 0; st < NUMSTAGES; st++) {
+    int position = myFetchStages[i * NUMSTAGES + st];
+    state.stageEntry[st] = (position == 0) ? -1 : i - (position - 1);
+  }
+  state.time = myFetchTimes[i];
+  state.nextFetch = i + 1;
+  return state;
+}
+
+/* stores state, the state right after some instruction was fetched,
+ * at index i of times and stages
+ */
+void IncrementalSimulation::setFetchState(vector<unsigned char> &stages, vector<int> &times,
+                                          int i, const PipelineState &state) {
+  int newest = state.nextFetch - 1;
+  for (int st = 0; st < NUMSTAGES; st++) {
+    int entry = state.stageEntry[st];
+    stages[i * NUMSTAGES + st] = (entry == -1) ? 0 : 1 + (newest - entry);
+  }
+  times[i] = state.time;
+}
@@ -0,0 +1,93 @@
+// Name: Maxine Xin
+#ifndef __INCREMENTALSIMULATION_H__
+#define __INCREMENTALSIMULATION_H__
+
+#include <vector>
+
+#include "Pipeline.h"
+
+using namespace std;
+
+/* This class keeps a list of instructions simulated on a kind of Pipeline,
+ * and updates the execution times when an instruction is inserted, deleted
+ * or replaced, without simulating the whole list again.
+ *
+ * Along with the execution times, the state of the pipeline right after each
+ * instruction is fetched is stored. After an edit at index k, the simulation
+ * is resumed from the state stored for instruction k - 1, on a pipeline that
+ * only holds the instructions around the edit (so only their dependences are
+ * analysed again), until the pipeline holds none of the edited instructions
+ * and reaches the same state as in the previous run. From there on, the
+ * previous run only needs to be shifted by the difference in time.
+ */
+class IncrementalSimulation {
+  public:
+    /* kind: a pipeline of the kind to simulate; it is only used to create
+     *       other pipelines of the same kind
+     */
+    IncrementalSimulation(Pipeline *kind);
+
+    /* stores and simulates the instructions
+     */
+    void load(const vector<Instruction> &instructions);
+
+    /* inserts instruction i before the instruction at index k (at the end
+     * if k is the number of instructions), and updates the execution times;
+     * returns false if k is out of range
+     */
+    bool insertInstruction(unsigned int k, const Instruction &i);
+
+    /* deletes the instruction at index k, and updates the execution times;
+     * returns false if k is out of range
+     */
+    bool deleteInstruction(unsigned int k);
+
+    /* replaces the instruction at index k by i, and updates the execution times;
+     * returns false if k is out of range
+     */
+    bool replaceInstruction(unsigned int k, const Instruction &i);
+
+    /* returns the instructions, and the execution time of each of them
+     */
+    const vector<Instruction> &getInstructions() { return myInstructions; };
+    const vector<int> &getExeTimes() { return myExeTimes; };
+
+    /* returns the execution time of the last instruction, 0 if there is none
+     */
+    int getTotalTime();
+
+    /* returns the number of instructions fetched when simulating the last edit
+     */
+    unsigned int getNumResimulated() { return myNumResimulated; };
+
+  private:
+    /* simulates again after an edit at index k; the instructions from index
+     * firstUnchanged on were at index + shift in the previous run
+     */
+    void resimulate(unsigned int k, unsigned int firstUnchanged, int shift);
+
+    /* returns the stored state right after instruction i was fetched
+     */
+    PipelineState getFetchState(int i);
+
+    /* stores state, the state right after some instruction was fetched,
+     * at index i of times and stages
+     */
+    void setFetchState(vector<unsigned char> &stages, vector<int> &times, int i,
+                       const PipelineState &state);
+
+    // number of instructions after the edit the pipeline holds at first;
+    // doubled as long as it is not enough to get back to the previous run
+    const static unsigned int WINDOW = 8 * NUMSTAGES;
+
+    Pipeline *myKind;
+    vector<Instruction> myInstructions;
+    vector<int> myExeTimes;
+    vector<int> myFetchTimes;              // time of the state after each fetch
+    vector<unsigned char> myFetchStages;   // stages of the state after each fetch,
+                                           // NUMSTAGES per inst: 0 if unoccupied, or
+                                           // 1 + how many insts were fetched after its inst
+    unsigned int myNumResimulated;
+};
+
+#endif
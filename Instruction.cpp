@@ -6,6 +6,7 @@ Instruction::Instruction()
 {
   myOpcode = UNDEFINED;
   myRS = myRT = myRD = NumRegisters;
+  myImmediate = 0;
   myEncoding = "";
   myAssembly = "";
   myExecutionTime = 0;
@@ -19,6 +20,7 @@ Instruction::Instruction(const Instruction & ref)
   myRS = ref.myRS;
   myRT = ref.myRT;
   myRD = ref.myRD;
+  myImmediate = ref.myImmediate;
   myEncoding = ref.myEncoding;
   myAssembly = ref.myAssembly;
   myExecutionTime = ref.myExecutionTime;
@@ -4,6 +4,7 @@
 
 #include "OpcodeTable.h"
 #include "RegisterTable.h"
+#include "MemoryAccount.h"
 #include <sstream>
 
 // This class provides an internal representation for a MIPS assembly instruction.
@@ -33,19 +34,19 @@ class Instruction{
   void setValues(Opcode op, Register rs, Register rt, Register rd, int imm);
 
   // Returns the Opcode of the instruction
-  Opcode getOpcode()   { return myOpcode;}
+  Opcode getOpcode() const  { return myOpcode;}
 
   // Returns the register used as the first source operand
-  Register getRS()     { return myRS; };
+  Register getRS() const    { return myRS; };
 
   // Returns the register used as the second source operand
-  Register getRT()     { return myRT; };
+  Register getRT() const    { return myRT; };
 
   // Returns the register used as the destination register
-  Register getRD()     { return myRD; };
+  Register getRD() const    { return myRD; };
 
   // Returns the value of the instruction's immediate field
-  int getImmediate()   { return myImmediate; };
+  int getImmediate() const  { return myImmediate; };
 
   // Returns the type of instruction 
   InstType getInstType();
@@ -54,7 +55,7 @@ class Instruction{
   void setAssembly(string assembly) { myAssembly = assembly; };
 
   // Returns the assembly representation of the instruction
-  string getAssembly() { return myAssembly;};
+  const string &getAssembly() const { return myAssembly;};
 
   // Stores the 32 bit binary encoding of MIPS instruction passed in
   void setEncoding(string s) { myEncoding = s;};
@@ -66,7 +67,13 @@ class Instruction{
   void setExeTime(int time) { myExecutionTime = time; }
  
   // Returns integer representing the execution time of the instruction
-  int getExeTime() { return myExecutionTime; };
+  int getExeTime() const { return myExecutionTime; };
+
+  // Returns the bytes the instruction takes, including its strings
+  size_t getMemoryUsage() const {
+    return sizeof(*this) + MemoryAccount::stringBytes(myAssembly) 
+      + MemoryAccount::stringBytes(myEncoding);
+  };
 
   // Returns true if instance is a memory instruction, retrns false otherwise
   //bool isMemoryInst();
@@ -0,0 +1,145 @@
+// Name: Maxine Xin
+#include "IntervalEstimator.h"
+
+#include <algorithm>
+
+// number of registers tracked, with HI and LO, as in DependencyChecker
+static const int NUMREGISTERS = DependencyChecker::REG_LO + 1;
+
+/* default constructor, no instructions analysed
+ */
+IntervalEstimator::IntervalEstimator() {
+  myNumInstructions = 0;
+  myNumJumps = 0;
+  myPairs.assign(NUMKINDS * NUMKINDS, 0);
+}
+
+/* builds the histograms of the instructions, in a single pass
+ */
+void IntervalEstimator::analyze(const vector<Instruction> &instructions) {
+  OpcodeTable opcodeTable;
+  DependencyChecker depChecker;
+  myNumInstructions = instructions.size();
+  myNumJumps = 0;
+  myPairs.assign(NUMKINDS * NUMKINDS, 0);
+
+  // the last instruction to access each register, and whether it wrote it;
+  // as in DependencyChecker, a read only depends on the last access if that
+  // access was a write
+  int lastAccess[NUMREGISTERS];
+  bool lastWasWrite[NUMREGISTERS];
+  for (int r = 0; r < NUMREGISTERS; r++) {
+    lastAccess[r] = -1;
+    lastWasWrite[r] = false;
+  }
+  vector<bool> isMemory(NUMSTAGES, false);     // class of the last NUMSTAGES insts
+
+  int previousKind = NUMSTAGES + NUMSTAGES * (NUMSTAGES + 1);   // no dependence, no jump
+  for (unsigned int i = 0; i < instructions.size(); i++) {
+    Opcode op = instructions[i].getOpcode();
+    RegisterAccesses accesses = depChecker.getAccesses(instructions[i]);
+
+    // distance to the closest producer of each class
+    int dMemory = NUMSTAGES;
+    int dOther = NUMSTAGES;
+    for (int r = 0; r < accesses.numReads; r++) {
+      int reg = accesses.reads[r];
+      if (lastWasWrite[reg] && (int)i - lastAccess[reg] < NUMSTAGES) {
+        int d = i - lastAccess[reg];
+        if (isMemory[lastAccess[reg] % NUMSTAGES])
+          dMemory = min(dMemory, d);
+        else
+          dOther = min(dOther, d);
+      }
+      lastAccess[reg] = i;
+      lastWasWrite[reg] = false;
+    }
+    for (int w = 0; w < accesses.numWrites; w++) {
+      lastAccess[accesses.writes[w]] = i;
+      lastWasWrite[accesses.writes[w]] = true;
+    }
+    isMemory[i % NUMSTAGES] = opcodeTable.isIMMMemory(op);
+
+    bool isJump = opcodeTable.isIMMLabel(op);
+    if (isJump && i + 1 < instructions.size())
+      myNumJumps++;
+    int kind = dMemory + (NUMSTAGES + 1) * (dOther + (NUMSTAGES + 1) * isJump);
+    myPairs[previousKind * NUMKINDS + kind]++;
+    previousKind = kind;
+  }
+}
+
+/* returns the estimated total time of the instructions analysed on a
+ * pipeline with the given config
+ */
+double IntervalEstimator::estimate(const PipelineConfig &config) {
+  if (myNumInstructions == 0)
+    return 0;
+
+  // the cycles between each kind of instruction and the next one it causes
+  // on its own: its stalls, and the bubble after it if it is a jump
+  vector<int> gap(NUMKINDS, 0);
+  int bubble = config.jumpDestProduced - FETCH;
+  for (int kind = 0; kind < NUMKINDS; kind++) {
+    gap[kind] = max(stall(config, true, kind % (NUMSTAGES + 1)),
+                    stall(config, false, (kind / (NUMSTAGES + 1)) % (NUMSTAGES + 1)));
+    if (kind / ((NUMSTAGES + 1) * (NUMSTAGES + 1)))
+      gap[kind] += bubble;
+  }
+
+  // every instruction takes a cycle, and the last one takes NUMSTAGES - 1
+  // more to get through; on top of that, each instruction stalls on its
+  // producers, except for the cycles the instruction before it already
+  // spent stalled or behind a bubble, which move the producers before it
+  // further away
+  unsigned long long cycles = myNumInstructions + NUMSTAGES - 1;
+  for (int previous = 0; previous < NUMKINDS; previous++) {
+    for (int kind = 0; kind < NUMKINDS; kind++) {
+      unsigned long long count = myPairs[previous * NUMKINDS + kind];
+      if (count == 0)
+        continue;
+      int dMemory = kind % (NUMSTAGES + 1);
+      int dOther = (kind / (NUMSTAGES + 1)) % (NUMSTAGES + 1);
+      int stallMemory = stall(config, true, dMemory);
+      int stallOther = stall(config, false, dOther);
+      if (dMemory > 1)
+        stallMemory = max(0, stallMemory - gap[previous]);
+      if (dOther > 1)
+        stallOther = max(0, stallOther - gap[previous]);
+      cycles += count * max(stallMemory, stallOther);
+      if (previous / ((NUMSTAGES + 1) * (NUMSTAGES + 1)))
+        cycles += count * bubble;
+    }
+  }
+  return cycles;
+}
+
+/* returns the number of instructions whose closest memory producer is
+ * at distance dMemory, and closest other producer at distance dOther
+ * (NUMSTAGES standing for no producer close enough to stall)
+ */
+unsigned long long IntervalEstimator::getCount(int dMemory, int dOther) {
+  unsigned long long count = 0;
+  for (int isJump = 0; isJump < 2; isJump++) {
+    int kind = dMemory + (NUMSTAGES + 1) * (dOther + (NUMSTAGES + 1) * isJump);
+    for (int previous = 0; previous < NUMKINDS; previous++) {
+      count += myPairs[previous * NUMKINDS + kind];
+    }
+  }
+  return count;
+}
+
+/* returns the number of cycles an instruction stalls on a producer of
+ * the given class at distance d (NUMSTAGES for no such producer)
+ */
+int IntervalEstimator::stall(const PipelineConfig &config, bool memory, int d) {
+  if (d >= NUMSTAGES)
+    return 0;
+  // the producer is d stages ahead of the instruction waiting in
+  // operandNeeded; with forwarding, the value is only there once the
+  // producer is past the stage it is produced in, while without, it is
+  // written back in that stage, and read in the same cycle
+  int produced = memory ? config.operandProducedMemory : config.operandProducedOther;
+  int available = produced + (config.forwarding ? 1 : 0);
+  return max(0, available - config.operandNeeded - d);
+}
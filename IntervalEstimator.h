@@ -0,0 +1,70 @@
+// Name: Maxine Xin
+#ifndef __INTERVALESTIMATOR_H__
+#define __INTERVALESTIMATOR_H__
+
+#include <vector>
+
+#include "Pipeline.h"
+
+using namespace std;
+
+/* This class estimates the total time of a list of instructions on a pipeline
+ * without simulating it, from a single pass over the instructions.
+ *
+ * The pass builds a histogram of the distance from each instruction to the
+ * closest instruction it has a RAW dependence on, by class of that producer
+ * (memory or not, since memory results are produced later), and counts the
+ * jumps. None of that depends on the pipeline, so the same histograms give
+ * an estimate for any PipelineConfig: every instruction takes one cycle, plus
+ * the stall cycles its RAW dependences cause at their distance (the larger of
+ * the two classes, as both wait at the same time), plus the bubble after each
+ * jump, plus the cycles the last instruction takes to go through the pipeline.
+ *
+ * Stalls mostly happen alone, but when an instruction stalls (or is a jump),
+ * the next one gets further away from its producers, and may not need to
+ * stall anymore; so the histograms are kept for each pair of consecutive
+ * instructions, and the stalls of the first one of the pair are taken off
+ * those of the second one.
+ */
+class IntervalEstimator {
+  public:
+    /* default constructor, no instructions analysed
+     */
+    IntervalEstimator();
+
+    /* builds the histograms of the instructions, in a single pass
+     */
+    void analyze(const vector<Instruction> &instructions);
+
+    /* returns the estimated total time of the instructions analysed on a
+     * pipeline with the given config
+     */
+    double estimate(const PipelineConfig &config);
+
+    /* returns the number of instructions whose closest memory producer is
+     * at distance dMemory, and closest other producer at distance dOther
+     * (NUMSTAGES standing for no producer close enough to stall)
+     */
+    unsigned long long getCount(int dMemory, int dOther);
+
+    /* returns the number of jumps followed by another instruction
+     */
+    unsigned long long getNumJumps() { return myNumJumps; };
+
+  private:
+    /* returns the number of cycles an instruction stalls on a producer of
+     * the given class at distance d (NUMSTAGES for no such producer)
+     */
+    int stall(const PipelineConfig &config, bool memory, int d);
+
+    // the closest producers of an instruction, and whether it is a jump, as
+    // one number: dMemory + (NUMSTAGES + 1) * (dOther + (NUMSTAGES + 1) * isJump)
+    const static int NUMKINDS = 2 * (NUMSTAGES + 1) * (NUMSTAGES + 1);
+
+    unsigned long long myNumInstructions;
+    unsigned long long myNumJumps;
+    vector<unsigned long long> myPairs;    // count of each (kind of the previous
+                                           // inst, kind of the inst), NUMKINDS^2
+};
+
+#endif
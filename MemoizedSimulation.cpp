@@ -0,0 +1,308 @@
+// Name: Maxine Xin
+#include "MemoizedSimulation.h"
+
+#include <cstring>
+
+/* A canonical state is laid out as follows, where an instruction is numbered
+ * by how many instructions were fetched after it (0 for the newest one):
+ *   bits  0 - 14: for each stage, 0 if unoccupied, or 1 + number of its inst
+ *   bits 15 - 24: for each of the instructions 0 - 4, its class
+ *   bits 25 - 34: for each of the instructions 0 - 3, its RAW dependences on
+ *                 the older instructions still in the pipeline (4, 3, 2 and 1 bits)
+ * Only instructions in the pipeline are described, so that states that only
+ * differ by instructions that have already completed are the same.
+ */
+static const int CLASS_SHIFT = 3 * NUMSTAGES;
+static const int RAW_SHIFT[NUMSTAGES - 1] = { 25, 29, 32, 34 };
+
+/* fastForward: if true, steady-state loops are fast-forwarded
+ * recordTimes: if false, the execution time of each instruction is not
+ *              stored (only the total time is)
+ */
+MemoizedSimulation::MemoizedSimulation(bool fastForward, bool recordTimes) {
+  myFastForward = fastForward;
+  myRecordTimes = recordTimes;
+  myMemoized = false;
+  myTotalTime = 0;
+  myNumTransitions = 0;
+  myNumHits = 0;
+  myNumMisses = 0;
+  myNumFastForwarded = 0;
+  myNumLoops = 0;
+}
+
+/* simulates the instructions on pipeline, which must already have been
+ * initialized with the same instructions, and stores the execution time
+ * of each instruction into pipeline
+ */
+void MemoizedSimulation::execute(Pipeline *pipeline, const vector<Instruction> &instructions) {
+  unsigned int numInstructions = instructions.size();
+  myNumHits = 0;
+  myNumMisses = 0;
+  myNumFastForwarded = 0;
+  myNumLoops = 0;
+  myTotalTime = 0;
+
+  // with too few instructions to fill the table, or nothing to stall on,
+  // simulating every cycle is faster
+  PipelineConfig config = pipeline->getConfig();
+  bool stalls = config.operandNeeded > FETCH || config.jumpDestProduced > FETCH;
+  myMemoized = numInstructions >= MINMEMOIZED && stalls;
+  if (!myMemoized) {
+    pipeline->execute();
+    if (numInstructions > 0)
+      myTotalTime = pipeline->getExeTimes().back();
+    return;
+  }
+
+  // transitions only hold for the pipeline that computed them
+  Transition free;
+  free.key = NO_KEY;
+  myTransitions.assign(TRANSITIONS, free);
+  myNumTransitions = 0;
+
+  // describe each instruction by its class and its RAW dependences on the
+  // instructions shortly before it
+  OpcodeTable opcodeTable;
+  DependencyChecker *depChecker = pipeline->getDependencyChecker();
+  myClass.assign(numInstructions, C_OTHER);
+  myRAWMask.assign(numInstructions, 0);
+  myDescription.assign(numInstructions, 0);
+  for (unsigned int i = 0; i < numInstructions; i++) {
+    Opcode op = instructions[i].getOpcode();
+    if (opcodeTable.isIMMLabel(op))
+      myClass[i] = C_JUMP;
+    else if (opcodeTable.isIMMMemory(op))
+      myClass[i] = C_MEMORY;
+
+    const vector<int> &producers = depChecker->getRAWProducers(i);
+    for (unsigned int p = 0; p < producers.size(); p++) {
+      int distance = i - producers[p];
+      if (distance < NUMSTAGES)
+        myRAWMask[i] |= 1 << (distance - 1);
+    }
+    myDescription[i] = myClass[i] | (myRAWMask[i] << 2);
+  }
+
+  // hash the window of each instruction, rolling it one instruction at a time
+  if (myFastForward) {
+    myWindowHash.assign(numInstructions, 0);
+    unsigned long long hash = 0;
+    unsigned long long dropped = 1;     // WINDOW_BASE to the power WINDOW
+    for (int w = 0; w < WINDOW; w++) {
+      dropped *= WINDOW_BASE;
+    }
+    for (unsigned int i = 0; i < numInstructions; i++) {
+      hash = hash * WINDOW_BASE + myDescription[i] + 1;
+      if (i >= (unsigned int)WINDOW)
+        hash -= dropped * (myDescription[i - WINDOW] + 1);
+      myWindowHash[i] = hash;
+    }
+  }
+
+  // the loop below goes through the descriptions and times as arrays, as
+  // it runs once per instruction
+  const unsigned char *descriptions = myDescription.data();
+  vector<int> times(myRecordTimes ? numInstructions : 0);
+  int *exeTimes = times.data();
+  vector<int> completed;
+  if (myFastForward) {
+    Occurrence none;
+    none.newest = -1;
+    myOccurrences.assign(OCCURRENCES, none);
+  }
+  unsigned long long state = 0;     // canonical state, empty pipeline to begin with
+  int newest = -1;                  // number of the inst fetched last
+  int time = 0;
+  unsigned int nextToComplete = 0;
+
+  while (nextToComplete < numInstructions) {
+    // describe what comes next: either the next instruction or the end
+    unsigned long long next = END_OF_INSTRUCTIONS;
+    if (newest + 1 < (int)numInstructions)
+      next = descriptions[newest + 1];
+    unsigned long long key = state | (next << STATE_BITS);
+
+    Transition *found = findTransition(key);
+    if (found == NULL) {
+      // run the pipeline itself for this transition, and store it
+      Transition tr;
+      tr.key = key;
+      PipelineState from = expand(state, newest, time);
+      completed.clear();
+      PipelineState reached;
+      if (next == END_OF_INSTRUCTIONS)
+        reached = pipeline->run(from, numInstructions, &completed);
+      else
+        reached = pipeline->run(from, newest + 1, &completed);
+
+      tr.nextState = (next == END_OF_INSTRUCTIONS) ? 0 : canonicalize(reached, newest + 1);
+      tr.cycles = reached.time - time;
+      tr.numCompleted = completed.size();
+      for (unsigned int c = 0; c < completed.size(); c++) {
+        tr.completionOffset[c] = completed[c] - time;
+      }
+      found = addTransition(tr);
+      myNumMisses++;
+    } else {
+      myNumHits++;
+    }
+
+    // replay the transition
+    const Transition &tr = *found;
+    if (tr.numCompleted > 0) {
+      if (myRecordTimes) {
+        for (int c = 0; c < tr.numCompleted; c++) {
+          exeTimes[nextToComplete + c] = time + tr.completionOffset[c];
+        }
+      }
+      nextToComplete += tr.numCompleted;
+      myTotalTime = time + tr.completionOffset[tr.numCompleted - 1];
+    }
+    time += tr.cycles;
+    state = tr.nextState;
+    newest++;
+
+    if (!myFastForward || newest + 1 >= (int)numInstructions)
+      continue;
+
+    // look for an earlier occurrence of the same state and window
+    unsigned long long window = hashWindow(newest);
+    Occurrence &seen = myOccurrences[(state ^ (state >> 29) ^ window) % OCCURRENCES];
+    if (seen.newest >= 0 && seen.state == state && seen.window == window) {
+      // skip one period at a time, as long as it repeats the last one; every
+      // period takes the same number of cycles, and completes the same
+      // number of instructions as it fetches
+      int period = newest - seen.newest;
+      int cyclesPerPeriod = time - seen.time;
+      int skipped = 0;
+      while (newest + period < (int)numInstructions && repeats(newest + 1, period)) {
+        if (myRecordTimes) {
+          for (int j = nextToComplete; j < (int)nextToComplete + period; j++) {
+            exeTimes[j] = exeTimes[j - period] + cyclesPerPeriod;
+          }
+        }
+        nextToComplete += period;
+        newest += period;
+        time += cyclesPerPeriod;
+        skipped += period;
+      }
+      if (skipped > 0) {
+        myNumFastForwarded += skipped;
+        myNumLoops++;
+        if (newest + 1 >= (int)numInstructions)
+          continue;
+        window = hashWindow(newest);
+      }
+    }
+    Occurrence &current = myOccurrences[(state ^ (state >> 29) ^ window) % OCCURRENCES];
+    current.state = state;
+    current.window = window;
+    current.newest = newest;
+    current.time = time;
+    current.nextToComplete = nextToComplete;
+  }
+
+  if (myRecordTimes)
+    pipeline->setExeTimes(times);
+}
+
+/* returns the transition from key in the table, or NULL if it has not
+ * been computed yet
+ */
+MemoizedSimulation::Transition *MemoizedSimulation::findTransition(unsigned long long key) {
+  unsigned int mask = myTransitions.size() - 1;
+  unsigned int e = (unsigned int)((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+  while (myTransitions[e].key != NO_KEY) {
+    if (myTransitions[e].key == key)
+      return &myTransitions[e];
+    e = (e + 1) & mask;
+  }
+  return NULL;
+}
+
+/* stores tr in the table, which grows once it is half full, and returns
+ * where it is
+ */
+MemoizedSimulation::Transition *MemoizedSimulation::addTransition(const Transition &tr) {
+  if (2 * (myNumTransitions + 1) > myTransitions.size()) {
+    vector<Transition> old;
+    old.swap(myTransitions);
+    Transition free;
+    free.key = NO_KEY;
+    myTransitions.assign(2 * old.size(), free);
+    myNumTransitions = 0;
+    for (unsigned int e = 0; e < old.size(); e++) {
+      if (old[e].key != NO_KEY)
+        addTransition(old[e]);
+    }
+  }
+  unsigned int mask = myTransitions.size() - 1;
+  unsigned int e = (unsigned int)((tr.key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+  while (myTransitions[e].key != NO_KEY) {
+    e = (e + 1) & mask;
+  }
+  myTransitions[e] = tr;
+  myNumTransitions++;
+  return &myTransitions[e];
+}
+
+/* returns true if the period instructions from first on have the same
+ * descriptions as the period instructions before them
+ */
+bool MemoizedSimulation::repeats(int first, int period) {
+  const unsigned char *descriptions = myDescription.data();
+  return memcmp(descriptions + first, descriptions + first - period, period) == 0;
+}
+
+/* returns the fraction of transitions replayed from the table
+ */
+double MemoizedSimulation::getHitRate() {
+  if (myNumHits + myNumMisses == 0)
+    return 0;
+  return (double)myNumHits / (myNumHits + myNumMisses);
+}
+
+/* returns the canonical state of state, where newest is the number of the
+ * instruction fetched last
+ */
+unsigned long long MemoizedSimulation::canonicalize(const PipelineState &state, int newest) {
+  unsigned long long key = 0;
+  int occupied = 0;           // bit r set if instruction r is in the pipeline
+
+  for (int st = 0; st < NUMSTAGES; st++) {
+    if (state.stageEntry[st] != -1) {
+      int r = newest - state.stageEntry[st];
+      key |= (unsigned long long)(r + 1) << (3 * st);
+      occupied |= 1 << r;
+    }
+  }
+
+  for (int r = 0; r < NUMSTAGES; r++) {
+    if (occupied & (1 << r))
+      key |= (unsigned long long)myClass[newest - r] << (CLASS_SHIFT + 2 * r);
+  }
+
+  // only keep the RAW dependences on instructions still in the pipeline
+  for (int r = 0; r < NUMSTAGES - 1; r++) {
+    if (occupied & (1 << r)) {
+      int mask = myRAWMask[newest - r] & (occupied >> (r + 1)) & ((1 << (NUMSTAGES - 1 - r)) - 1);
+      key |= (unsigned long long)mask << RAW_SHIFT[r];
+    }
+  }
+  return key;
+}
+
+/* returns the pipeline state corresponding to the canonical state key,
+ * where newest is the number of the instruction fetched last
+ */
+PipelineState MemoizedSimulation::expand(unsigned long long key, int newest, int time) {
+  PipelineState state;
+  for (int st = 0; st < NUMSTAGES; st++) {
+    int position = (key >> (3 * st)) & 7;
+    state.stageEntry[st] = (position == 0) ? -1 : newest - (position - 1);
+  }
+  state.time = time;
+  state.nextFetch = newest + 1;
+  return state;
+}
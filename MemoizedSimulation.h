@@ -0,0 +1,182 @@
+// Name: Maxine Xin
+#ifndef __MEMOIZEDSIMULATION_H__
+#define __MEMOIZEDSIMULATION_H__
+
+#include <vector>
+
+#include "Pipeline.h"
+
+using namespace std;
+
+/* This class simulates a list of instructions on a Pipeline as an automaton.
+ * Right after an instruction is fetched, everything that decides how the
+ * pipeline evolves is small: which of the last NUMSTAGES instructions sits in
+ * each stage, the class of each of them (jump, memory, other), and the RAW
+ * dependences among them. That canonical state, together with the class and
+ * the RAW dependences of the next instruction, determines the number of
+ * cycles until the next instruction is fetched, the instructions completed
+ * on the way, and the next canonical state.
+ *
+ * Each transition is computed once by running the pipeline itself, and stored
+ * in a hash table (open addressing, probed linearly); later occurrences of
+ * the same transition are replayed from the table, so over a long list of
+ * instructions, the simulation is mostly table lookups. The result is the same as the one of
+ * Pipeline::execute(), provided the pipeline only looks at the classes and
+ * RAW dependences of the instructions it holds, as IDEAL, STALL and
+ * FORWARDING do. Filling the table takes a few hundred thousand
+ * instructions before replaying pays off, and replaying cannot beat a
+ * pipeline that never stalls (IDEAL), so with fewer instructions than
+ * MINMEMOIZED, or such a pipeline, every cycle is simulated instead.
+ *
+ * Optionally, steady-state loops are fast-forwarded: when the same canonical
+ * state comes back together with the same window of recent instructions, and
+ * the instructions since the last occurrence (the period) keep repeating,
+ * the pipeline goes through the same states again every period, each one
+ * taking the same number of cycles; so each following period that repeats
+ * the last one is skipped without running through its transitions, and the
+ * completion time of each instruction skipped is that of the same
+ * instruction one period earlier, plus the cycles per period. Checking a
+ * period compares its descriptions once, and the window hashes are rolled
+ * over the instructions beforehand, so a skipped instruction costs no more
+ * than a comparison and a copy of its time.
+ */
+class MemoizedSimulation {
+  public:
+    /* fastForward: if true, steady-state loops are fast-forwarded
+     * recordTimes: if false, the execution time of each instruction is not
+     *              stored (only the total time is), which saves memory and
+     *              time on long lists of instructions
+     */
+    MemoizedSimulation(bool fastForward = false, bool recordTimes = true);
+
+    /* simulates the instructions on pipeline, which must already have been
+     * initialized with the same instructions, and stores the execution time
+     * of each instruction into pipeline
+     */
+    void execute(Pipeline *pipeline, const vector<Instruction> &instructions);
+
+    /* returns true if the last call to execute() replayed transitions, false
+     * if it simulated every cycle instead (see MINMEMOIZED)
+     */
+    bool isMemoized() { return myMemoized; };
+
+    // the fewest instructions memoized, below which every cycle is simulated
+    const static unsigned int MINMEMOIZED = 1 << 18;
+
+    /* returns the number of transitions replayed from the table / computed by
+     * running the pipeline in the last call to execute()
+     */
+    unsigned long long getNumHits() { return myNumHits; };
+    unsigned long long getNumMisses() { return myNumMisses; };
+
+    /* returns the fraction of transitions replayed from the table
+     */
+    double getHitRate();
+
+    /* returns the total time of the last call to execute(), i.e. the
+     * execution time of the last instruction
+     */
+    int getTotalTime() { return myTotalTime; };
+
+    /* returns the number of instructions skipped by fast-forwarding / the
+     * number of times a loop was fast-forwarded in the last call to execute()
+     */
+    unsigned long long getNumFastForwarded() { return myNumFastForwarded; };
+    unsigned long long getNumLoops() { return myNumLoops; };
+
+  private:
+    // what happens between the fetch of an instruction and the fetch of the
+    // next one (or the end of the simulation, after the last instruction)
+    struct Transition {
+      unsigned long long key;                // state and next inst it starts from
+      unsigned long long nextState;          // canonical state reached
+      int cycles;                            // cycles elapsed
+      int numCompleted;                      // instructions completed, in order,
+      int completionOffset[NUMSTAGES];       // and their times relative to the start
+    };
+
+    // the class of an instruction, as far as the pipelines are concerned
+    enum InstClass {
+      C_OTHER,
+      C_MEMORY,
+      C_JUMP
+    };
+
+    // where a canonical state was seen together with a window of
+    // instructions, for detecting steady-state loops
+    struct Occurrence {
+      unsigned long long state;
+      unsigned long long window;
+      int newest;
+      int time;
+      unsigned int nextToComplete;
+    };
+
+    /* returns a number describing the class and RAW dependences of instruction i
+     */
+    int describe(int i) { return myDescription[i]; };
+
+    /* returns the transition from key in the table, or NULL if it has not
+     * been computed yet
+     */
+    Transition *findTransition(unsigned long long key);
+
+    /* stores tr in the table, which grows once it is half full, and returns
+     * where it is
+     */
+    Transition *addTransition(const Transition &tr);
+
+    /* returns a hash of the descriptions of the WINDOW instructions up to newest
+     */
+    unsigned long long hashWindow(int newest) { return myWindowHash[newest]; };
+
+    /* returns true if the period instructions from first on have the same
+     * descriptions as the period instructions before them
+     */
+    bool repeats(int first, int period);
+
+    /* returns the canonical state of state, where newest is the number of the
+     * instruction fetched last
+     */
+    unsigned long long canonicalize(const PipelineState &state, int newest);
+
+    /* returns the pipeline state corresponding to the canonical state key,
+     * where newest is the number of the instruction fetched last
+     */
+    PipelineState expand(unsigned long long key, int newest, int time);
+
+    // number of bits of a canonical state; the next instruction is
+    // described in the bits above
+    const static int STATE_BITS = 35;
+    // describes the end of the instructions instead of a next instruction
+    const static unsigned long long END_OF_INSTRUCTIONS = 1ULL << 6;
+    // marks a free entry of the table of transitions, which no key has
+    const static unsigned long long NO_KEY = ~0ULL;
+    // number of entries the table of transitions starts with (a power of two)
+    const static int TRANSITIONS = 1 << 12;
+    // number of instructions whose descriptions are hashed into the window
+    const static int WINDOW = 16;
+    // multiplier of the (polynomial, rolling) hash of a window
+    const static unsigned long long WINDOW_BASE = 1099511628211ULL;
+    // number of entries of the (direct-mapped) table of occurrences
+    const static int OCCURRENCES = 1 << 16;
+
+    vector<unsigned char> myClass;      // class of each instruction
+    vector<unsigned char> myRAWMask;    // bit d - 1 set if the instruction has a RAW
+                                        // dependence on the instruction d before it
+    vector<unsigned char> myDescription; // what describe() returns, for each instruction
+    vector<unsigned long long> myWindowHash; // what hashWindow() returns, for each instruction
+    vector<Transition> myTransitions;   // open addressing, probed linearly
+    unsigned int myNumTransitions;
+    vector<Occurrence> myOccurrences;
+    bool myFastForward;
+    bool myRecordTimes;
+    bool myMemoized;
+    int myTotalTime;
+    unsigned long long myNumHits;
+    unsigned long long myNumMisses;
+    unsigned long long myNumFastForwarded;
+    unsigned long long myNumLoops;
+};
+
+#endif
@@ -0,0 +1,84 @@
+// Name: Maxine Xin
+#include "MemoryAccount.h"
+#include "Profiler.h"
+
+#include <cctype>
+#include <cstdlib>
+
+/* adds bytes to component (created at the end of the list if new);
+ * held is false for a component that was freed before the next ones
+ * were allocated (e.g. a parser), which is not part of the total
+ */
+void MemoryAccount::add(const string &component, size_t bytes, bool held) {
+  for (unsigned int c = 0; c < myComponents.size(); c++) {
+    if (myComponents[c].name == component) {
+      myComponents[c].bytes += bytes;
+      return;
+    }
+  }
+  Component entry;
+  entry.name = component;
+  entry.bytes = bytes;
+  entry.held = held;
+  myComponents.push_back(entry);
+}
+
+/* returns the bytes of the components held at once
+ */
+size_t MemoryAccount::getTotal() {
+  size_t total = 0;
+  for (unsigned int c = 0; c < myComponents.size(); c++) {
+    if (myComponents[c].held)
+      total += myComponents[c].bytes;
+  }
+  return total;
+}
+
+/* writes a line per component to out, with its bytes, its share of the
+ * total and its bytes per instruction, then the total and the peak
+ * resident set size of the process for comparison
+ */
+void MemoryAccount::write(ostream &out, unsigned long long numInstructions) {
+  size_t total = getTotal();
+  out << "Component \t\t Bytes \t\t Share \t Bytes/inst" << endl;
+  for (unsigned int c = 0; c < myComponents.size(); c++) {
+    const Component &component = myComponents[c];
+    out << component.name << "\t\t" << component.bytes << "\t\t";
+    if (!component.held)
+      out << "(freed)";
+    else if (total > 0)
+      out << component.bytes * 100.0 / total << "%";
+    out << "\t";
+    if (numInstructions > 0)
+      out << (double)component.bytes / numInstructions;
+    out << endl;
+  }
+  out << "Total held \t\t" << total << endl;
+  long peakRSS = Profiler::getPeakRSS();
+  if (peakRSS > 0)
+    out << "Peak RSS \t\t" << peakRSS * 1024 << endl;
+}
+
+/* reads a number of bytes, with an optional k, m or g suffix (powers of
+ * 1024) into bytes; returns false if size cannot be read
+ */
+bool MemoryAccount::parseSize(const string &size, size_t &bytes) {
+  char *end = NULL;
+  double number = strtod(size.c_str(), &end);
+  if (end == size.c_str() || number < 0)
+    return false;
+  string suffix(end);
+  double unit = 1;
+  if (suffix.length() > 1 && tolower(suffix[1]) == 'b')
+    suffix = suffix.substr(0, 1);
+  if (suffix == "k" || suffix == "K")
+    unit = 1024.0;
+  else if (suffix == "m" || suffix == "M")
+    unit = 1024.0 * 1024;
+  else if (suffix == "g" || suffix == "G")
+    unit = 1024.0 * 1024 * 1024;
+  else if (suffix.length() > 0)
+    return false;
+  bytes = (size_t)(number * unit);
+  return true;
+}
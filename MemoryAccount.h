@@ -0,0 +1,93 @@
+// Name: Maxine Xin
+#ifndef __MEMORYACCOUNT_H__
+#define __MEMORYACCOUNT_H__
+
+#include <cstddef>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/* This class adds up the bytes held by each component of a simulation
+ * (the parsers, the instructions, the dependence checker and the rest of
+ * each pipeline, the report buffers), as each of them reports it with its
+ * getMemoryUsage() method, and prints them out.
+ *
+ * The sizes are worked out from the contents of the containers instead of
+ * by counting allocations: a list node is its element and two pointers,
+ * a map node its element and four words (color, parent and children), a
+ * string its capacity unless it fits inside the string itself, and a
+ * vector its capacity. They are thus close to what the allocator hands
+ * out, without its own overhead.
+ */
+class MemoryAccount {
+  public:
+    /* adds bytes to component (created at the end of the list if new);
+     * held is false for a component that was freed before the next ones
+     * were allocated (e.g. a parser), which is not part of the total
+     */
+    void add(const string &component, size_t bytes, bool held = true);
+
+    /* returns the bytes of the components held at once
+     */
+    size_t getTotal();
+
+    /* writes a line per component to out, with its bytes, its share of the
+     * total and its bytes per instruction, then the total and the peak
+     * resident set size of the process for comparison
+     */
+    void write(ostream &out, unsigned long long numInstructions);
+
+    /* reads a number of bytes, with an optional k, m or g suffix (powers of
+     * 1024) into bytes; returns false if size cannot be read
+     */
+    static bool parseSize(const string &size, size_t &bytes);
+
+    /* returns the bytes a string / vector / list holds outside itself; for
+     * objects with a getMemoryUsage() of their own, each element counts for
+     * what it reports instead of its size
+     */
+    static size_t stringBytes(const string &s) {
+      const char *data = s.data();
+      const char *object = (const char*)&s;
+      bool inside = data >= object && data < object + sizeof(s);
+      return inside ? 0 : s.capacity() + 1;
+    };
+
+    template <class T> static size_t vectorBytes(const vector<T> &v) {
+      return v.capacity() * sizeof(T);
+    };
+
+    template <class T> static size_t listBytes(const list<T> &l) {
+      return l.size() * (sizeof(T) + 2 * sizeof(void*));
+    };
+
+    template <class T> static size_t objectVectorBytes(const vector<T> &v) {
+      size_t bytes = (v.capacity() - v.size()) * sizeof(T);
+      for (typename vector<T>::const_iterator it = v.begin(); it != v.end(); it++) {
+        bytes += it -> getMemoryUsage();
+      }
+      return bytes;
+    };
+
+    template <class T> static size_t objectListBytes(const list<T> &l) {
+      size_t bytes = l.size() * 2 * sizeof(void*);
+      for (typename list<T>::const_iterator it = l.begin(); it != l.end(); it++) {
+        bytes += it -> getMemoryUsage();
+      }
+      return bytes;
+    };
+
+  private:
+    struct Component {
+      string name;
+      size_t bytes;
+      bool held;
+    };
+
+    vector<Component> myComponents;    // in the order they were added
+};
+
+#endif
@@ -0,0 +1,77 @@
+// Name: Maxine Xin
+#include "ParserBenchmark.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+using namespace std;
+
+/* This file runs the microbenchmarks of the parsers (see ParserBenchmark.h),
+ * prints out the ns and heap allocations per operation of each to stderr,
+ * and compares them against a baseline: it exits with status 1 if any of
+ * them allocates more, and only warns about the ones slower by more than
+ * the threshold, since the time varies from run to run.
+ *
+ * usage: MICROBENCH [-output F] [-baseline B] [-threshold P] [-lines N]
+ *                   [-seed X] [-mintime S]
+ *   -output F: writes the results as JSON to file F
+ *   -baseline B: compares against the results in file B (written by -output);
+ *                a missing file is only reported
+ *   -threshold P: largest slowdown not warned about, in percent (default 20)
+ *   -lines N: number of lines of the mix (default 4096)
+ *   -seed X: seed of the lines (default 1)
+ *   -mintime S: seconds each benchmark runs for, at least, in each of its
+ *               9 repetitions (default 0.1)
+ *
+ */
+
+int main(int argc, char *argv[]) {
+  string outputFilename;
+  string baselineFilename;
+  double threshold = 20;
+  unsigned int numLines = 4096;
+  unsigned int seed = 1;
+  double minSeconds = 0.1;
+
+  for (int arg = 1; arg < argc; arg++) {
+    string option = argv[arg];
+    if (option == "-output" && arg + 1 < argc) {
+      outputFilename = argv[++arg];
+    } else if (option == "-baseline" && arg + 1 < argc) {
+      baselineFilename = argv[++arg];
+    } else if (option == "-threshold" && arg + 1 < argc) {
+      threshold = atof(argv[++arg]);
+    } else if (option == "-lines" && arg + 1 < argc) {
+      numLines = atoi(argv[++arg]);
+    } else if (option == "-seed" && arg + 1 < argc) {
+      seed = atoi(argv[++arg]);
+    } else if (option == "-mintime" && arg + 1 < argc) {
+      minSeconds = atof(argv[++arg]);
+    } else {
+      cerr << "Unknown option " << option << endl;
+      exit(1);
+    }
+  }
+
+  ParserBenchmark benchmark(numLines, seed, minSeconds);
+  vector<BenchmarkResult> results = benchmark.run();
+
+  if (outputFilename.length() > 0) {
+    ofstream out(outputFilename.c_str());
+    if (!out) {
+      cerr << "Cannot write results to " << outputFilename << endl;
+      exit(1);
+    }
+    ParserBenchmark::writeJSON(out, results);
+  }
+
+  vector<BenchmarkResult> baseline;
+  if (baselineFilename.length() > 0 && !ParserBenchmark::readJSON(baselineFilename, baseline))
+    cerr << "No baseline in " << baselineFilename << endl;
+  int numRegressions = ParserBenchmark::compare(cerr, results, baseline, threshold);
+  if (numRegressions > 0) {
+    cerr << numRegressions << " benchmarks allocate more than in the baseline." << endl;
+    exit(1);
+  }
+  return(0);
+}
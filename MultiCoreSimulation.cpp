@@ -0,0 +1,176 @@
+// Name: Maxine Xin
+#include "MultiCoreSimulation.h"
+
+#include "MemoryAccount.h"
+
+/* cores sharing a bus making busWidth transfers per cycle (at least 1)
+ * for their loads, and their fetches if fetchOnBus, in the order of
+ * arbitration
+ */
+MultiCoreSimulation::MultiCoreSimulation(unsigned int busWidth, BusArbitration arbitration,
+                                         bool fetchOnBus) {
+  myBusWidth = (busWidth == 0) ? 1 : busWidth;
+  myArbitration = arbitration;
+  myFetchOnBus = fetchOnBus;
+  myNumCores = 0;
+  myTotalTime = 0;
+  myNumTransfers = 0;
+}
+
+/* stores the instructions of each trace, for a core of its own, and
+ * their dependences
+ */
+void MultiCoreSimulation::initialize(const vector<vector<Instruction> > &traces) {
+  myNumCores = traces.size();
+  myFirst.assign(myNumCores, 0);
+  myNumInstructions.assign(myNumCores, 0);
+
+  // lay the instructions of the cores and their producers out one after
+  // the other
+  myOpcodes.clear();
+  myProducerStart.assign(1, 0);
+  myProducers.clear();
+  for (unsigned int c = 0; c < myNumCores; c++) {
+    myFirst[c] = myOpcodes.size();
+    myNumInstructions[c] = traces[c].size();
+    DependencyChecker depChecker;
+    for (unsigned int i = 0; i < traces[c].size(); i++) {
+      depChecker.addInstruction(traces[c][i]);
+      myOpcodes.push_back(traces[c][i].getOpcode());
+    }
+    for (unsigned int i = 0; i < traces[c].size(); i++) {
+      const vector<int> &producers = depChecker.getRAWProducers(i);
+      myProducers.insert(myProducers.end(), producers.begin(), producers.end());
+      myProducerStart.push_back(myProducers.size());
+    }
+  }
+}
+
+/* simulates the cores all together, stalling as config does
+ */
+void MultiCoreSimulation::execute(const PipelineConfig &config) {
+  myConfig = config;
+  myNextFetch.assign(myNumCores, 0);
+  myNumCompleted.assign(myNumCores, 0);
+  myTotalTimes.assign(myNumCores, 0);
+  myNumBusStalls.assign(myNumCores, 0);
+  for (int st = 0; st < NUMSTAGES; st++) {
+    myStageEntry[st].assign(myNumCores, -1);
+  }
+  myTotalTime = 0;
+  myNumTransfers = 0;
+  unsigned int numRunning = 0;
+  for (unsigned int c = 0; c < myNumCores; c++) {
+    if (myNumInstructions[c] > 0)
+      numRunning++;
+  }
+
+  unsigned int first = 0;     // core asking for the bus first
+  int time = 0;
+  while (numRunning > 0) {
+    unsigned int numTransfers = 0;
+    int lastServed = -1;
+    // as in Pipeline::run(), the later stages make room first, in every core
+    for (int st = NUMSTAGES - 1; st >= 0; st--) {
+      vector<int> &entry = myStageEntry[st];
+      bool onBus = st == MEMORY || (st == FETCH && myFetchOnBus);
+      for (unsigned int k = 0; k < myNumCores; k++) {
+        unsigned int c = first + k;
+        if (c >= myNumCores)
+          c -= myNumCores;
+        if (st == NUMSTAGES - 1 && entry[c] != -1) {
+          entry[c] = -1;
+          myNumCompleted[c]++;
+          if (myNumCompleted[c] == myNumInstructions[c]) {
+            myTotalTimes[c] = time;
+            numRunning--;
+          }
+        }
+
+        int i;
+        if (st == FETCH)
+          i = (myNextFetch[c] < myNumInstructions[c]) ? (int)myNextFetch[c] : -1;
+        else
+          i = myStageEntry[st - 1][c];
+        if (i == -1 || !canMove(c, st))
+          continue;
+        // a load (or a fetch) only moves on with a transfer on the bus
+        if (onBus && (st == FETCH || myOpcodeTable.isIMMMemory(myOpcodes[myFirst[c] + i]))) {
+          if (numTransfers == myBusWidth) {
+            myNumBusStalls[c]++;
+            continue;
+          }
+          numTransfers++;
+          lastServed = c;
+        }
+        entry[c] = i;
+        if (st == FETCH)
+          myNextFetch[c]++;
+        else
+          myStageEntry[st - 1][c] = -1;
+      }
+    }
+    myNumTransfers += numTransfers;
+    if (myArbitration == ARBITRATE_ROUND_ROBIN && lastServed != -1)
+      first = (lastServed + 1 == (int)myNumCores) ? 0 : lastServed + 1;
+    time++;
+  }
+  for (unsigned int c = 0; c < myNumCores; c++) {
+    myTotalTime = max(myTotalTime, myTotalTimes[c]);
+  }
+}
+
+/* returns the bytes held by the simulation
+ */
+size_t MultiCoreSimulation::getMemoryUsage() const {
+  size_t bytes = sizeof(*this);
+  bytes += MemoryAccount::vectorBytes(myFirst) + MemoryAccount::vectorBytes(myNumInstructions);
+  bytes += MemoryAccount::vectorBytes(myNextFetch) + MemoryAccount::vectorBytes(myNumCompleted);
+  bytes += MemoryAccount::vectorBytes(myTotalTimes) + MemoryAccount::vectorBytes(myNumBusStalls);
+  for (int st = 0; st < NUMSTAGES; st++) {
+    bytes += MemoryAccount::vectorBytes(myStageEntry[st]);
+  }
+  bytes += MemoryAccount::vectorBytes(myOpcodes);
+  bytes += MemoryAccount::vectorBytes(myProducerStart) + MemoryAccount::vectorBytes(myProducers);
+  return bytes;
+}
+
+/* returns true if the instruction before stage st of core c (or to be
+ * fetched, for st = FETCH) can move into it in this cycle, leaving
+ * the bus aside
+ */
+bool MultiCoreSimulation::canMove(unsigned int c, int st) {
+  // if the stage is occupied
+  if (myStageEntry[st][c] != -1)
+    return false;
+  const Opcode *opcodes = &myOpcodes[myFirst[c]];
+
+  // nothing is fetched while a jump is before the stage its destination
+  // is produced in (included)
+  if (st == FETCH) {
+    for (int jumpSt = FETCH + 1; jumpSt <= myConfig.jumpDestProduced; jumpSt++) {
+      int jump = myStageEntry[jumpSt][c];
+      if (jump != -1 && myOpcodeTable.isIMMLabel(opcodes[jump]))
+        return false;
+    }
+    return true;
+  }
+
+  // the inst leaves stage operandNeeded once none of its producers is in
+  // the stages from st to the one its result is available after, as in a
+  // SuperscalarPipeline of width 1
+  if (st != myConfig.operandNeeded + 1 || myConfig.operandNeeded <= FETCH)
+    return true;
+  unsigned int consumer = myFirst[c] + myStageEntry[st - 1][c];
+  for (unsigned int p = myProducerStart[consumer]; p < myProducerStart[consumer + 1]; p++) {
+    int producer = myProducers[p];
+    bool memory = myOpcodeTable.isIMMMemory(opcodes[producer]);
+    int produced = memory ? myConfig.operandProducedMemory : myConfig.operandProducedOther;
+    int available = min(produced + (myConfig.forwarding ? 1 : 0), NUMSTAGES - 1);
+    for (int pSt = st; pSt <= available; pSt++) {
+      if (myStageEntry[pSt][c] == producer)
+        return false;
+    }
+  }
+  return true;
+}
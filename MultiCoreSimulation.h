@@ -0,0 +1,110 @@
+// Name: Maxine Xin
+#ifndef __MULTICORESIMULATION_H__
+#define __MULTICORESIMULATION_H__
+
+#include <vector>
+
+#include "Pipeline.h"
+
+using namespace std;
+
+// which core gets the bus first, when more ask for it than it can serve
+enum BusArbitration {
+  ARBITRATE_ROUND_ROBIN,   // the one after the core served last
+  ARBITRATE_FIXED          // the lowest numbered one
+};
+
+/* This class simulates K cores in lockstep, each a pipeline running a list
+ * of instructions of its own, which share a memory bus: each load moving
+ * into MEMORY (and, if asked, each instruction being fetched) needs a
+ * transfer on the bus in that cycle, and the bus only makes so many
+ * transfers per cycle, so that the others stay where they are (a
+ * structural stall) until they get one. The cores ask for the bus in the
+ * order of the arbitration, the loads of every core before the fetches.
+ *
+ * Each core stalls as the pipeline whose PipelineConfig is given does
+ * (e.g. the one of a StallPipeline or a ForwardingPipeline, by its stages
+ * rather than forwarding paths), one instruction per stage: with a bus as
+ * wide as the number of cores (twice that with the fetches), each one takes
+ * the same cycles as that pipeline alone.
+ *
+ * The state of the cores is kept as arrays of one entry per core (the
+ * instruction in each stage of every core, the next one each fetches, ...)
+ * and their instructions in flat arrays, so that each cycle goes through
+ * every core stage by stage, without a call to a Pipeline.
+ */
+class MultiCoreSimulation {
+  public:
+    /* cores sharing a bus making busWidth transfers per cycle (at least 1)
+     * for their loads, and their fetches if fetchOnBus, in the order of
+     * arbitration
+     */
+    MultiCoreSimulation(unsigned int busWidth = 1,
+                        BusArbitration arbitration = ARBITRATE_ROUND_ROBIN,
+                        bool fetchOnBus = false);
+
+    /* stores the instructions of each trace, for a core of its own, and
+     * their dependences
+     */
+    void initialize(const vector<vector<Instruction> > &traces);
+
+    /* simulates the cores all together, stalling as config does
+     */
+    void execute(const PipelineConfig &config);
+
+    /* returns the number of transfers the bus makes per cycle
+     */
+    unsigned int getBusWidth() { return myBusWidth; };
+
+    /* returns the number of cores, and, for the last call to execute(), the
+     * number of instructions, the completion time of the last one and the
+     * cycles an instruction waited for the bus (in all) of each
+     */
+    unsigned int getNumCores() { return myNumCores; };
+    unsigned int getNumInstructions(unsigned int core) { return myNumInstructions[core]; };
+    long long getTotalTime(unsigned int core) { return myTotalTimes[core]; };
+    long long getNumBusStalls(unsigned int core) { return myNumBusStalls[core]; };
+
+    /* returns, for the last call to execute(), the completion time of the
+     * last instruction of all the cores, and the number of transfers the
+     * bus made
+     */
+    long long getTotalTime() { return myTotalTime; };
+    long long getNumTransfers() { return myNumTransfers; };
+
+    /* returns the bytes held by the simulation
+     */
+    size_t getMemoryUsage() const;
+
+  private:
+    /* returns true if the instruction before stage st of core c (or to be
+     * fetched, for st = FETCH) can move into it in this cycle, leaving
+     * the bus aside
+     */
+    bool canMove(unsigned int c, int st);
+
+    PipelineConfig myConfig;
+    unsigned int myBusWidth;
+    BusArbitration myArbitration;
+    bool myFetchOnBus;
+    OpcodeTable myOpcodeTable;
+
+    unsigned int myNumCores;
+    vector<unsigned int> myFirst;            // of each core: its first inst in the
+    vector<unsigned int> myNumInstructions;  // flat arrays, its number of insts,
+    vector<unsigned int> myNextFetch;        // the next one to fetch,
+    vector<unsigned int> myNumCompleted;     // the ones completed, the time
+    vector<long long> myTotalTimes;          // the last one completed, and the
+    vector<long long> myNumBusStalls;        // cycles insts waited for the bus
+    vector<int> myStageEntry[NUMSTAGES];     // number of the inst in each stage of
+                                             // each core, -1 if unoccupied
+
+    vector<Opcode> myOpcodes;                // of every inst of every core,
+    vector<unsigned int> myProducerStart;    // and where its RAW producers are
+    vector<int> myProducers;                 // in myProducers (numbers in its core)
+
+    long long myTotalTime;
+    long long myNumTransfers;
+};
+
+#endif
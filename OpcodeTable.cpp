@@ -95,7 +95,6 @@ OpcodeTable::OpcodeTable()
   myArray[LB].funct_field = ""; 
   myArray[LB].immMemory = true;
 
-  /*
   myArray[BEQ].name = "beq";
   myArray[BEQ].numOps = 3;
   myArray[BEQ].rdPos = -1;
@@ -106,7 +105,6 @@ OpcodeTable::OpcodeTable()
   myArray[BEQ].op_field = "000100";
   myArray[BEQ].funct_field = "";
   myArray[BEQ].immLabel = true; 
-  */
 
   myArray[J].name = "j";
   myArray[J].numOps = 1;
@@ -238,6 +236,15 @@ bool OpcodeTable::isIMMLabel(Opcode o)
   return myArray[o].immLabel;
 }
 
+bool OpcodeTable::isBranch(Opcode o)
+// Given an Opcode, returns true if instruction is a conditional branch, which
+// reads its RT field instead of writing it. See "BEQ".
+{
+  if(o < 0 || o >= UNDEFINED)
+    return false;
+  return myArray[o].instType == ITYPE && myArray[o].immLabel;
+}
+
 bool OpcodeTable::isIMMMemory(Opcode o)
 // Given an Opcode, returns true is instruction expects an offset in the instruction.
 // See "LB".
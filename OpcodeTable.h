@@ -18,7 +18,7 @@ enum Opcode {
   SLT,
   SLTI,
   LB,
-  //BEQ,
+  BEQ,
   J,
   UNDEFINED
 };
@@ -73,6 +73,10 @@ class OpcodeTable {
   // See "J".
   bool isIMMLabel(Opcode o);
 
+  // Given an Opcode, returns true if instruction is a conditional branch, which
+  // reads its RT field instead of writing it. See "BEQ".
+  bool isBranch(Opcode o);
+
   // Given an Opcode, returns true is instruction expects an memory adress in the instruction.
   // See "LB".
   bool isIMMMemory(Opcode o);
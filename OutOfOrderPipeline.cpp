@@ -0,0 +1,315 @@
+// Name: Maxine Xin
+#include <climits>
+
+#include "OutOfOrderPipeline.h"
+
+/* creates an out-of-order pipeline named name, of width W, with a ROB
+ * of robSize entries and numStations reservation stations (at most 64)
+ */
+OutOfOrderPipeline::OutOfOrderPipeline(string name, unsigned int width, unsigned int robSize,
+                                       unsigned int numStations) : Pipeline() {
+  myName = name;
+  myWidth = (width == 0) ? 1 : width;
+  myROBSize = (robSize == 0) ? 1 : robSize;
+  myNumStations = (numStations == 0) ? 1 : numStations;
+  if (myNumStations > MAXSTATIONS)
+    myNumStations = MAXSTATIONS;
+
+  // the ring holds the next power of two entries, so that inst i is found
+  // at i & myROBMask
+  unsigned int capacity = 1;
+  while (capacity < myROBSize) {
+    capacity <<= 1;
+  }
+  myROBMask = capacity - 1;
+  myROB.resize(capacity);
+  myStations.resize(myNumStations);
+  myFreeStations = 0;
+  myReadyStations = 0;
+  myDue.resize((MAXLATENCY + 1) * myWidth * MAXLATENCY);
+  myNumDue.assign(MAXLATENCY + 1, 0);
+
+  myTotalTime = 0;
+  myNumROBFull = 0;
+  myNumStationsFull = 0;
+  myNumOperandWait = 0;
+  myNumIssueWait = 0;
+}
+
+/* sets which jumps and branches are predicted right at fetch (by a
+ * BranchPredictor), so that the next instruction is fetched right after
+ * them; fetching waits for the destination of the others to be
+ * produced, as it does for every one by default
+ */
+void OutOfOrderPipeline::setPredicted(const vector<bool> &predicted) {
+  myPredicted = predicted;
+}
+
+/* returns a newly allocated, uninitialized OutOfOrderPipeline with the
+ * same name, width, sizes and predictions
+ */
+Pipeline *OutOfOrderPipeline::createEmpty() {
+  OutOfOrderPipeline *pipeline = new OutOfOrderPipeline(myName, myWidth, myROBSize, myNumStations);
+  pipeline->setPredicted(myPredicted);
+  return pipeline;
+}
+
+/* returns the stages operands are needed and produced in (as in a
+ * ForwardingPipeline)
+ */
+PipelineConfig OutOfOrderPipeline::getConfig() {
+  PipelineConfig config;
+  config.operandNeeded = MY_STAGE_OPERAND_NEEDED;
+  config.operandProducedMemory = MY_STAGE_OPERAND_PRODUCED_MMR;
+  config.operandProducedOther = MY_STAGE_OPERAND_PRODUCED_NONMMR;
+  config.forwarding = true;
+  config.jumpDestProduced = MY_STAGE_JUMP_DEST_PRODUCED;
+  config.forwardPaths = FORWARD_BY_STAGES;
+  return config;
+}
+
+/* models processing the instructions out of order, computes the
+ * execution (commit) time for each instruction and stores it (see
+ * getExeTimes())
+ */
+void OutOfOrderPipeline::execute() {
+  unsigned int numInstructions = myInstructions.size();
+  myFreeStations = (myNumStations == MAXSTATIONS) ? ~(uint64_t)0
+                                                  : (((uint64_t)1 << myNumStations) - 1);
+  myReadyStations = 0;
+  myNumDue.assign(MAXLATENCY + 1, 0);
+  myTotalTime = 0;
+  myNumROBFull = 0;
+  myNumStationsFull = 0;
+  myNumOperandWait = 0;
+  myNumIssueWait = 0;
+
+  findProducers();
+  unsigned int head = 0;         // next inst to commit, the oldest in the ROB
+  unsigned int nextDecode = 0;   // next inst to decode; the ones from it to
+  unsigned int nextFetch = 0;    // nextFetch (excluded) are fetched
+  int fetchResume = 0;           // cycle fetching may resume after a jump
+  int time = 0;
+  while (head < numInstructions) {
+    // commit the oldest insts that have left WRITEBACK, in order
+    for (unsigned int k = 0; k < myWidth && head < nextDecode; k++) {
+      int doneTime = myROB[head & myROBMask].doneTime;
+      if (doneTime == -1 || doneTime > time)
+        break;
+      myExeTimes[head] = time;
+      recordEntry(head, NUMSTAGES, time);
+      head++;
+    }
+
+    // broadcast the results produced by now
+    int slot = time % (MAXLATENCY + 1);
+    unsigned int base = slot * myWidth * MAXLATENCY;
+    for (int k = 0; k < myNumDue[slot]; k++) {
+      broadcast(myDue[base + k], time);
+    }
+    myNumDue[slot] = 0;
+
+    // issue the oldest ready insts
+    for (unsigned int k = 0; k < myWidth && myReadyStations != 0; k++) {
+      uint64_t ready = myReadyStations;
+      unsigned int oldest = __builtin_ctzll(ready);
+      ready &= ready - 1;
+      while (ready != 0) {
+        unsigned int s = __builtin_ctzll(ready);
+        if (myStations[s].inst < myStations[oldest].inst)
+          oldest = s;
+        ready &= ready - 1;
+      }
+      issue(oldest, time);
+    }
+
+    // decode the fetched insts in order, while there is room for them
+    bool decodeStalled = false;
+    for (unsigned int k = 0; k < myWidth && nextDecode < nextFetch; k++) {
+      if (nextDecode - head >= myROBSize) {
+        myNumROBFull++;
+        decodeStalled = true;
+        break;
+      }
+      if (myFreeStations == 0) {
+        myNumStationsFull++;
+        decodeStalled = true;
+        break;
+      }
+      decode(nextDecode, time, head);
+      // the destination of a jump is known once it is decoded
+      if (holdsFetch(nextDecode))
+        fetchResume = time + 1;
+      nextDecode++;
+    }
+    if (decodeStalled) {
+      myStallCause = STALL_STRUCTURAL;
+      for (unsigned int i = nextDecode; i < nextFetch; i++) {
+        recordStall(i);
+      }
+    }
+
+    // fetch as many insts as the fetch buffer has room for, up to a jump
+    if (time < fetchResume) {
+      if (nextFetch < numInstructions) {
+        // if the jump is held up because there is no room for it, that is
+        // what the inst to be fetched waits for
+        myStallCause = decodeStalled ? STALL_STRUCTURAL : STALL_JUMP;
+        recordStall(nextFetch);
+      }
+    } else {
+      while (nextFetch < numInstructions && nextFetch - nextDecode < myWidth) {
+        recordEntry(nextFetch, FETCH, time);
+        nextFetch++;
+        if (holdsFetch(nextFetch - 1)) {
+          fetchResume = INT_MAX;
+          break;
+        }
+      }
+    }
+    time++;
+  }
+  myTotalTime = (numInstructions > 0) ? time - 1 : 0;
+}
+
+/* returns, for the last call to execute(), the instructions committed
+ * per cycle, and the number of cycles no instruction could be decoded
+ * because the ROB / all reservation stations were full
+ */
+double OutOfOrderPipeline::getIPC() {
+  if (myTotalTime == 0)
+    return 0;
+  return (double)myInstructions.size() / myTotalTime;
+}
+
+/* returns the bytes held by the pipeline
+ */
+size_t OutOfOrderPipeline::getMemoryUsage() const {
+  size_t bytes = Pipeline::getMemoryUsage() - sizeof(Pipeline) + sizeof(*this);
+  bytes += MemoryAccount::vectorBytes(myROB);
+  bytes += MemoryAccount::vectorBytes(myStations);
+  bytes += MemoryAccount::vectorBytes(myDue);
+  bytes += MemoryAccount::vectorBytes(myNumDue);
+  bytes += MemoryAccount::vectorBytes(myProducerStart) + MemoryAccount::vectorBytes(myProducers);
+  bytes += myPredicted.capacity() / 8;
+  return bytes;
+}
+
+/* returns the cycles from the issue of instruction i until its result
+ * can be forwarded to an instruction issuing then
+ */
+int OutOfOrderPipeline::getLatency(unsigned int i) {
+  if (myOpcodeTable.isIMMMemory(myOpcodes[i]))
+    return MY_STAGE_OPERAND_PRODUCED_MMR - MY_STAGE_OPERAND_NEEDED + 1;
+  return MY_STAGE_OPERAND_PRODUCED_NONMMR - MY_STAGE_OPERAND_NEEDED + 1;
+}
+
+/* finds the RAW producers of every instruction: the last instruction
+ * to write each register it reads
+ */
+void OutOfOrderPipeline::findProducers() {
+  // the DependencyChecker only reports a RAW dependence for the first read
+  // of a register after it is written, but each reader has to wait for it,
+  // so the producers come from the last writer of each register, as in a
+  // DependenceGraph
+  vector<int> lastWriter(DependencyChecker::REG_LO + 1, -1);
+  myProducerStart.assign(1, 0);
+  myProducers.clear();
+  for (list<Instruction>::iterator it = myInstructions.begin(); it != myInstructions.end(); it++) {
+    RegisterAccesses accesses = myDepChecker.getAccesses(*it);
+    for (int r = 0; r < accesses.numReads; r++) {
+      if (lastWriter[accesses.reads[r]] != -1)
+        myProducers.push_back(lastWriter[accesses.reads[r]]);
+    }
+    for (int w = 0; w < accesses.numWrites; w++) {
+      lastWriter[accesses.writes[w]] = myProducerStart.size() - 1;
+    }
+    myProducerStart.push_back(myProducers.size());
+  }
+}
+
+/* decodes instruction i into a free station and the ROB at time, looking
+ * up which of its producers it has to wait for
+ */
+void OutOfOrderPipeline::decode(unsigned int i, int time, unsigned int robHead) {
+  unsigned int s = __builtin_ctzll(myFreeStations);
+  uint64_t bit = (uint64_t)1 << s;
+  myFreeStations &= ~bit;
+
+  Station &station = myStations[s];
+  station.inst = i;
+  station.pending = 0;
+  station.decodeTime = time;
+  station.readyTime = time + 1;
+  station.producer = -1;
+
+  // a producer already committed, or whose result has been broadcast, is
+  // available; the others wake the station up when they broadcast
+  for (unsigned int p = myProducerStart[i]; p < myProducerStart[i + 1]; p++) {
+    if ((unsigned int)myProducers[p] < robHead)
+      continue;
+    ROBEntry &entry = myROB[myProducers[p] & myROBMask];
+    if (entry.resultReady || (entry.waiting & bit))
+      continue;
+    entry.waiting |= bit;
+    station.pending++;
+  }
+  if (station.pending == 0)
+    myReadyStations |= bit;
+
+  ROBEntry &entry = myROB[i & myROBMask];
+  entry.doneTime = -1;
+  entry.resultReady = false;
+  entry.waiting = 0;
+  recordEntry(i, DECODE, time);
+}
+
+/* issues the instruction in station s at time
+ */
+void OutOfOrderPipeline::issue(unsigned int s, int time) {
+  uint64_t bit = (uint64_t)1 << s;
+  myReadyStations &= ~bit;
+  myFreeStations |= bit;
+
+  Station &station = myStations[s];
+  unsigned int i = station.inst;
+  // it waited for its operands from the cycle after it was decoded, then
+  // for an issue slot
+  if (station.producer != -1 && station.readyTime > station.decodeTime + 1)
+    myNumOperandWait += station.readyTime - station.decodeTime - 1;
+  if (time > station.readyTime)
+    myNumIssueWait += time - station.readyTime;
+
+  myROB[i & myROBMask].doneTime = time + (NUMSTAGES - EXECUTE);
+  recordEntry(i, EXECUTE, time);
+  recordEntry(i, MEMORY, time + 1);
+  recordEntry(i, WRITEBACK, time + 2);
+
+  int slot = (time + getLatency(i)) % (MAXLATENCY + 1);
+  myDue[slot * myWidth * MAXLATENCY + myNumDue[slot]] = i;
+  myNumDue[slot]++;
+}
+
+/* broadcasts the result of instruction i at time, waking up the
+ * stations waiting for it
+ */
+void OutOfOrderPipeline::broadcast(unsigned int i, int time) {
+  ROBEntry &entry = myROB[i & myROBMask];
+  entry.resultReady = true;
+  uint64_t waiting = entry.waiting;
+  entry.waiting = 0;
+  while (waiting != 0) {
+    unsigned int s = __builtin_ctzll(waiting);
+    waiting &= waiting - 1;
+    Station &station = myStations[s];
+    // of the producers broadcasting together, the closest is the one it
+    // stalls on, as in the other pipelines
+    if (station.readyTime < time || (int)i > station.producer) {
+      station.readyTime = time;
+      station.producer = i;
+    }
+    station.pending--;
+    if (station.pending == 0)
+      myReadyStations |= (uint64_t)1 << s;
+  }
+}
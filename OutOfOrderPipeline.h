@@ -0,0 +1,177 @@
+// Name: Maxine Xin
+#ifndef __OUTOFORDERPIPELINE_H__
+#define __OUTOFORDERPIPELINE_H__
+
+#include <stdint.h>
+
+#include "Pipeline.h"
+
+/* This class models an out-of-order pipeline in the style of Tomasulo's
+ * algorithm with a reorder buffer. Up to W instructions are fetched per
+ * cycle (none past a jump until it is decoded), and decoded in order into
+ * the reorder buffer (ROB) and a reservation station each, as long as
+ * there is room in both. Registers are renamed, so only the RAW
+ * dependences hold an instruction back, each on the last instruction to
+ * write a register it reads (however many read it before): it issues, up
+ * to W per cycle oldest first, once the results it reads are available,
+ * forwarded as soon as they are produced (at the end of EXECUTE, or of
+ * MEMORY for a load), and then goes through EXECUTE, MEMORY and WRITEBACK. Instructions commit in order, up to W per cycle, and the
+ * cycle each one commits is its execution time.
+ *
+ * The ROB is a ring buffer indexed by instruction number, and a reservation
+ * station is a bit of a 64-bit mask: each ROB entry holds the mask of the
+ * stations waiting for its result, which are woken up by clearing their
+ * pending count when the result is broadcast, from a ring of the results
+ * due in each of the next few cycles; so there are at most 64 stations.
+ *
+ * The stalls recorded are the cycles an instruction waited to be decoded
+ * for room in the ROB or the stations (structural) and, as in the other
+ * pipelines, the cycles the instruction after a jump waited to be fetched.
+ * A jump or branch that is predicted (see setPredicted()) does not hold up
+ * fetching. The cycles instructions waited in their stations, for their
+ * operands or, ready, for an issue slot, overlap with one another and with
+ * the others issuing, so they are not stalls but metrics of their own.
+ *
+ * As in SuperscalarPipeline, only execute() simulates the out-of-order
+ * pipeline.
+ */
+class OutOfOrderPipeline : public Pipeline {
+  public:
+    /* creates an out-of-order pipeline named name, of width W, with a ROB
+     * of robSize entries and numStations reservation stations (at most 64)
+     */
+    OutOfOrderPipeline(string name, unsigned int width = 1, unsigned int robSize = 32,
+                       unsigned int numStations = 16);
+
+    /* destructor
+     */
+    ~OutOfOrderPipeline() {};
+
+    /* sets which jumps and branches are predicted right at fetch (by a
+     * BranchPredictor), so that the next instruction is fetched right after
+     * them; fetching waits for the destination of the others to be
+     * produced, as it does for every one by default
+     */
+    void setPredicted(const vector<bool> &predicted);
+
+    /* returns a newly allocated, uninitialized OutOfOrderPipeline with the
+     * same name, width, sizes and predictions
+     */
+    Pipeline *createEmpty();
+
+    /* returns the stages operands are needed and produced in (as in a
+     * ForwardingPipeline)
+     */
+    PipelineConfig getConfig();
+
+    /* returns the number of instructions issued per cycle, at most (W)
+     */
+    unsigned int getWidth() { return myWidth; };
+
+    /* models processing the instructions out of order, computes the
+     * execution (commit) time for each instruction and stores it (see
+     * getExeTimes())
+     */
+    void execute();
+
+    /* returns, for the last call to execute(), the instructions committed
+     * per cycle, and the number of cycles no instruction could be decoded
+     * because the ROB / all reservation stations were full
+     */
+    double getIPC();
+    long long getNumROBFullCycles() { return myNumROBFull; };
+    long long getNumStationsFullCycles() { return myNumStationsFull; };
+
+    /* returns, for the last call to execute(), the cycles instructions
+     * waited in their stations for their operands, and, with their
+     * operands available, for an issue slot (added up over instructions)
+     */
+    long long getNumOperandWaitCycles() { return myNumOperandWait; };
+    long long getNumIssueWaitCycles() { return myNumIssueWait; };
+
+    /* returns the bytes held by the pipeline
+     */
+    size_t getMemoryUsage() const;
+
+    // the most reservation stations, one per bit of a mask
+    const static unsigned int MAXSTATIONS = 64;
+
+  private:
+    // an instruction in the ROB
+    struct ROBEntry {
+      int doneTime;             // cycle it leaves WRITEBACK, -1 until issued
+      bool resultReady;         // whether its result has been broadcast
+      uint64_t waiting;         // stations waiting for its result
+    };
+
+    // an instruction waiting to issue
+    struct Station {
+      unsigned int inst;
+      int pending;              // results it still waits for
+      int decodeTime;           // cycle it was decoded
+      int readyTime;            // cycle its last operand became available
+      int producer;             // the last producer it waited for, -1 if none
+    };
+
+    /* returns the cycles from the issue of instruction i until its result
+     * can be forwarded to an instruction issuing then
+     */
+    int getLatency(unsigned int i);
+
+    /* returns true if fetching waits for the destination of instruction i
+     * to be produced: it is a jump or a branch that was not predicted
+     */
+    bool holdsFetch(unsigned int i) {
+      return myOpcodeTable.isIMMLabel(myOpcodes[i]) && (i >= myPredicted.size() || !myPredicted[i]);
+    };
+
+    /* finds the RAW producers of every instruction: the last instruction
+     * to write each register it reads
+     */
+    void findProducers();
+
+    /* decodes instruction i into a free station and the ROB at time, looking
+     * up which of its producers it has to wait for
+     */
+    void decode(unsigned int i, int time, unsigned int robHead);
+
+    /* issues the instruction in station s at time
+     */
+    void issue(unsigned int s, int time);
+
+    /* broadcasts the result of instruction i at time, waking up the
+     * stations waiting for it
+     */
+    void broadcast(unsigned int i, int time);
+
+    // the stages operands are needed and produced in, as in a ForwardingPipeline
+    const Stage MY_STAGE_OPERAND_NEEDED = EXECUTE;
+    const Stage MY_STAGE_OPERAND_PRODUCED_MMR = MEMORY;
+    const Stage MY_STAGE_OPERAND_PRODUCED_NONMMR = EXECUTE;
+    const Stage MY_STAGE_JUMP_DEST_PRODUCED = DECODE;
+    // the longest latency, and thus how far ahead results are due
+    const static int MAXLATENCY = MEMORY - EXECUTE + 1;
+
+    unsigned int myWidth;
+    unsigned int myROBSize;
+    unsigned int myNumStations;
+    vector<bool> myPredicted;         // whether each jump or branch is predicted
+
+    vector<ROBEntry> myROB;           // ring buffer, entry i & myROBMask for inst i
+    unsigned int myROBMask;
+    vector<Station> myStations;
+    uint64_t myFreeStations;          // bit s set if station s is free,
+    uint64_t myReadyStations;         // and if it is ready to issue
+    vector<int> myDue;                // ring of the insts whose result is due at
+    vector<int> myNumDue;             // each of the next MAXLATENCY + 1 cycles
+    vector<unsigned int> myProducerStart;  // where the RAW producers of each
+    vector<int> myProducers;               // inst are in myProducers
+
+    long long myTotalTime;
+    long long myNumROBFull;
+    long long myNumStationsFull;
+    long long myNumOperandWait;
+    long long myNumIssueWait;
+};
+
+#endif
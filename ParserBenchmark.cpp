@@ -0,0 +1,256 @@
+// Name: Maxine Xin
+#include "ParserBenchmark.h"
+#include "WorkloadGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <new>
+
+// every heap allocation of the program goes through here to be counted
+static unsigned long long numAllocations = 0;
+
+void *operator new(size_t size) {
+  numAllocations++;
+  void *p = malloc(size == 0 ? 1 : size);
+  if (p == NULL)
+    throw bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) noexcept {
+  free(p);
+}
+
+/* prepares numLines lines generated with seed; each benchmark runs for
+ * at least minSeconds, repetitions times
+ */
+ParserBenchmark::ParserBenchmark(unsigned int numLines, unsigned int seed,
+                                 double minSeconds, int repetitions) {
+  myMinSeconds = minSeconds;
+  myRepetitions = repetitions;
+  mySink = 0;
+
+  WorkloadGenerator generator(seed);
+  generator.setTypicalMix();
+  ASMParser parser;
+  for (unsigned int l = 0; l < numLines; l++) {
+    string line = generator.nextLine();
+    Instruction inst;
+    string opcode;
+    vector<string> operands(MAXOPERANDS);
+    int numOperands = 0;
+    myASMParser.getTokens(line, opcode, &operands[0], numOperands);
+    if (numOperands == 0 || !parser.parseLine(line, inst))
+      continue;
+    operands.resize(numOperands);
+
+    myLines.push_back(line);
+    myEncodings.push_back(inst.getEncoding());
+    myInstructions.push_back(inst);
+    myLineOpcodes.push_back(inst.getOpcode());
+    myOperands.push_back(operands);
+    myOpcodeNames.push_back(opcode);
+    for (int o = 0; o < numOperands; o++) {
+      if (operands[o].length() > 0 && operands[o][0] == '$')
+        myRegisterNames.push_back(operands[o]);
+    }
+  }
+}
+
+/* runs every benchmark, and returns their results
+ */
+vector<BenchmarkResult> ParserBenchmark::run() {
+  vector<BenchmarkResult> results;
+  measure("asm_getTokens", &ParserBenchmark::passGetTokens, myLines.size(), results);
+  measure("asm_getOperands", &ParserBenchmark::passGetOperands, myLines.size(), results);
+  measure("asm_encode", &ParserBenchmark::passEncode, myLines.size(), results);
+  measure("bin_checkSyntax", &ParserBenchmark::passCheckSyntax, myEncodings.size(), results);
+  measure("bin_decode2Inst", &ParserBenchmark::passDecode2Inst, myEncodings.size(), results);
+  measure("bin_cvt2ASM", &ParserBenchmark::passCvt2ASM, myInstructions.size(), results);
+  measure("reg_getNum", &ParserBenchmark::passGetNum, myRegisterNames.size(), results);
+  measure("op_getOpcode", &ParserBenchmark::passGetOpcode, myOpcodeNames.size(), results);
+  return results;
+}
+
+/* writes results as JSON / reads them back from filename, returning
+ * false if the file cannot be read
+ */
+void ParserBenchmark::writeJSON(ostream &out, const vector<BenchmarkResult> &results) {
+  out << "{\"benchmarks\":[" << endl;
+  for (unsigned int r = 0; r < results.size(); r++) {
+    out << "{\"name\":\"" << results[r].name << "\",\"ns_per_op\":" << results[r].nsPerOp
+        << ",\"allocs_per_op\":" << results[r].allocsPerOp << ",\"ops\":" << results[r].ops << "}";
+    out << ((r + 1 < results.size()) ? "," : "") << endl;
+  }
+  out << "]}" << endl;
+}
+
+bool ParserBenchmark::readJSON(string filename, vector<BenchmarkResult> &results) {
+  ifstream in(filename.c_str());
+  if (!in)
+    return false;
+  // one benchmark per line, as written by writeJSON()
+  string line;
+  while (getline(in, line)) {
+    string::size_type name = line.find("\"name\":\"");
+    string::size_type ns = line.find("\"ns_per_op\":");
+    string::size_type allocs = line.find("\"allocs_per_op\":");
+    string::size_type ops = line.find("\"ops\":");
+    if (name == string::npos || ns == string::npos || allocs == string::npos)
+      continue;
+    BenchmarkResult result;
+    name += 8;
+    result.name = line.substr(name, line.find('"', name) - name);
+    result.nsPerOp = atof(line.c_str() + ns + 12);
+    result.allocsPerOp = atof(line.c_str() + allocs + 16);
+    result.ops = (ops == string::npos) ? 0 : strtoull(line.c_str() + ops + 6, NULL, 10);
+    results.push_back(result);
+  }
+  return true;
+}
+
+/* writes a line per result to out, with its change from the result of
+ * the same name in baseline if any, warning about the ones slower by more
+ * than threshold percent, and returns the number of results with more
+ * allocations per operation than in baseline
+ */
+int ParserBenchmark::compare(ostream &out, const vector<BenchmarkResult> &results,
+                             const vector<BenchmarkResult> &baseline, double threshold) {
+  map<string, const BenchmarkResult*> byName;
+  for (unsigned int b = 0; b < baseline.size(); b++) {
+    byName[baseline[b].name] = &baseline[b];
+  }
+
+  int numRegressions = 0;
+  out << "Benchmark \t\t ns/op \t\t allocs/op \t Change" << endl;
+  for (unsigned int r = 0; r < results.size(); r++) {
+    const BenchmarkResult &result = results[r];
+    out << result.name << "\t\t" << result.nsPerOp << "\t\t" << result.allocsPerOp << "\t\t";
+    map<string, const BenchmarkResult*>::iterator base = byName.find(result.name);
+    if (base == byName.end() || base -> second -> nsPerOp <= 0) {
+      out << "(no baseline)" << endl;
+      continue;
+    }
+    double change = (result.nsPerOp / base -> second -> nsPerOp - 1) * 100;
+    out << (change >= 0 ? "+" : "") << change << "%";
+    // allocations do not vary from run to run, so any more is a regression,
+    // while the time varies too much from run to run (and from machine to
+    // machine) to fail on, so being slower is only a warning
+    if (result.allocsPerOp > base -> second -> allocsPerOp + 0.01) {
+      numRegressions++;
+      out << "  REGRESSION (" << base -> second -> allocsPerOp << " allocs/op before)";
+    } else if (change > threshold) {
+      out << "  slower (warning only)";
+    }
+    out << endl;
+  }
+  return numRegressions;
+}
+
+/* returns the number of heap allocations so far
+ */
+unsigned long long ParserBenchmark::getNumAllocations() {
+  return numAllocations;
+}
+
+/* times pass, which does opsPerPass operations, and adds its result
+ * named name to results
+ */
+void ParserBenchmark::measure(const string &name, void (ParserBenchmark::*pass)(),
+                              unsigned long long opsPerPass, vector<BenchmarkResult> &results) {
+  BenchmarkResult result;
+  result.name = name;
+  result.nsPerOp = 0;
+  result.allocsPerOp = 0;
+  result.ops = 0;
+  if (opsPerPass == 0) {
+    results.push_back(result);
+    return;
+  }
+
+  // once to warm up, and to count the allocations of a pass
+  unsigned long long allocations = numAllocations;
+  (this->*pass)();
+  result.allocsPerOp = (double)(numAllocations - allocations) / opsPerPass;
+
+  // the median of the repetitions, which a few slow ones (the machine
+  // doing something else) do not move
+  vector<pair<double, unsigned long long> > reps;
+  for (int rep = 0; rep < myRepetitions; rep++) {
+    unsigned long long passes = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    chrono::duration<double> elapsed;
+    do {
+      (this->*pass)();
+      passes++;
+      elapsed = chrono::steady_clock::now() - start;
+    } while (elapsed.count() < myMinSeconds);
+    reps.push_back(make_pair(elapsed.count() * 1e9 / (passes * opsPerPass), passes * opsPerPass));
+  }
+  if (!reps.empty()) {
+    sort(reps.begin(), reps.end());
+    result.nsPerOp = reps[reps.size() / 2].first;
+    result.ops = reps[reps.size() / 2].second;
+  }
+  results.push_back(result);
+}
+
+/* go once over all the prepared lines, for each benchmark
+ */
+void ParserBenchmark::passGetTokens() {
+  string opcode;
+  string operands[MAXOPERANDS];
+  for (unsigned int l = 0; l < myLines.size(); l++) {
+    int numOperands = 0;
+    myASMParser.getTokens(myLines[l], opcode, operands, numOperands);
+    mySink += numOperands;
+  }
+}
+
+void ParserBenchmark::passGetOperands() {
+  Instruction inst;
+  for (unsigned int l = 0; l < myLines.size(); l++) {
+    mySink += myASMParser.getOperands(inst, myLineOpcodes[l], &myOperands[l][0],
+                                      myOperands[l].size());
+  }
+}
+
+void ParserBenchmark::passEncode() {
+  for (unsigned int l = 0; l < myInstructions.size(); l++) {
+    mySink += myASMParser.encode(myInstructions[l]).length();
+  }
+}
+
+void ParserBenchmark::passCheckSyntax() {
+  for (unsigned int l = 0; l < myEncodings.size(); l++) {
+    mySink += myBinaryParser.checkSyntax(myEncodings[l]);
+  }
+}
+
+void ParserBenchmark::passDecode2Inst() {
+  Instruction inst;
+  for (unsigned int l = 0; l < myEncodings.size(); l++) {
+    mySink += myBinaryParser.decode2Inst(inst, myEncodings[l]);
+  }
+}
+
+void ParserBenchmark::passCvt2ASM() {
+  for (unsigned int l = 0; l < myInstructions.size(); l++) {
+    mySink += myBinaryParser.cvt2ASM(myInstructions[l]).length();
+  }
+}
+
+void ParserBenchmark::passGetNum() {
+  for (unsigned int r = 0; r < myRegisterNames.size(); r++) {
+    mySink += myRegisters.getNum(myRegisterNames[r]);
+  }
+}
+
+void ParserBenchmark::passGetOpcode() {
+  for (unsigned int o = 0; o < myOpcodeNames.size(); o++) {
+    mySink += myOpcodes.getOpcode(myOpcodeNames[o]);
+  }
+}
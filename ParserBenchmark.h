@@ -0,0 +1,107 @@
+// Name: Maxine Xin
+#ifndef __PARSERBENCHMARK_H__
+#define __PARSERBENCHMARK_H__
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ASMParser.h"
+#include "BinaryParser.h"
+#include "OpcodeTable.h"
+#include "RegisterTable.h"
+
+using namespace std;
+
+// the result of one microbenchmark
+struct BenchmarkResult {
+  string name;
+  double nsPerOp;          // median of the repetitions
+  double allocsPerOp;      // heap allocations (operator new) per operation
+  unsigned long long ops;  // operations timed in the median repetition
+};
+
+/* This class times the steps the parsers go through for each line, one at
+ * a time, over a realistic mix of lines (from WorkloadGenerator::
+ * setTypicalMix()), prepared beforehand so that each step only measures
+ * itself: ASMParser::getTokens, getOperands and encode, BinaryParser::
+ * checkSyntax, decode2Inst and cvt2ASM, RegisterTable::getNum and
+ * OpcodeTable::getOpcode.
+ *
+ * Each step goes over all the lines as many times as fits in a minimum
+ * time, a number of times over, and the median time per operation is
+ * kept; the heap allocations are counted by replacing the global operator
+ * new, so they are only counted in a program linked with ParserBenchmark.o.
+ *
+ * Results can be written as JSON, one benchmark per line, read back, and
+ * compared against a baseline.
+ */
+class ParserBenchmark {
+  public:
+    /* prepares numLines lines generated with seed; each benchmark runs for
+     * at least minSeconds, repetitions times
+     */
+    ParserBenchmark(unsigned int numLines = 4096, unsigned int seed = 1,
+                    double minSeconds = 0.1, int repetitions = 9);
+
+    /* runs every benchmark, and returns their results
+     */
+    vector<BenchmarkResult> run();
+
+    /* writes results as JSON / reads them back from filename, returning
+     * false if the file cannot be read
+     */
+    static void writeJSON(ostream &out, const vector<BenchmarkResult> &results);
+    static bool readJSON(string filename, vector<BenchmarkResult> &results);
+
+    /* writes a line per result to out, with its change from the result of
+     * the same name in baseline if any, warning about the ones slower by more
+     * than threshold percent, and returns the number of results with more
+     * allocations per operation than in baseline
+     */
+    static int compare(ostream &out, const vector<BenchmarkResult> &results,
+                       const vector<BenchmarkResult> &baseline, double threshold);
+
+    /* returns the number of heap allocations so far
+     */
+    static unsigned long long getNumAllocations();
+
+  private:
+    /* times pass, which does opsPerPass operations, and adds its result
+     * named name to results
+     */
+    void measure(const string &name, void (ParserBenchmark::*pass)(), unsigned long long opsPerPass,
+                 vector<BenchmarkResult> &results);
+
+    /* go once over all the prepared lines, for each benchmark
+     */
+    void passGetTokens();
+    void passGetOperands();
+    void passEncode();
+    void passCheckSyntax();
+    void passDecode2Inst();
+    void passCvt2ASM();
+    void passGetNum();
+    void passGetOpcode();
+
+    const static int MAXOPERANDS = 80;     // as many operands as ASMParser::parseLine() allows
+
+    double myMinSeconds;
+    int myRepetitions;
+    ASMParser myASMParser;
+    BinaryParser myBinaryParser;
+    RegisterTable myRegisters;
+    OpcodeTable myOpcodes;
+
+    vector<string> myLines;                // assembly
+    vector<string> myEncodings;            // binary encodings of the same instructions
+    vector<Opcode> myLineOpcodes;          // opcode of each line,
+    vector<vector<string> > myOperands;    // and its operands, as getTokens() finds them
+    vector<Instruction> myInstructions;    // each line parsed
+    vector<string> myOpcodeNames;          // mnemonic of each line
+    vector<string> myRegisterNames;        // every register operand of the lines
+    long long mySink;                      // results are added up here, so that nothing
+                                           // the benchmarks compute is left unused
+};
+
+#endif
@@ -0,0 +1,117 @@
+// Name: Maxine Xin
+#include "PerfCounters.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+PerfCounters::PerfCounters() {
+  for (int e = 0; e < NUMPERFEVENTS; e++) {
+    myFds[e] = -1;
+  }
+}
+
+/* closes the events
+ */
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  // close the members of the group before its leader
+  for (int e = NUMPERFEVENTS - 1; e >= 0; e--) {
+    if (myFds[e] >= 0)
+      close(myFds[e]);
+  }
+#endif
+}
+
+/* opens the events, and returns false (with the reason in getError())
+ * if none of them can be counted
+ */
+bool PerfCounters::open() {
+#ifdef __linux__
+  const unsigned int types[NUMPERFEVENTS] = {
+    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE
+  };
+  const unsigned long long configs[NUMPERFEVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                           | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  for (int e = 0; e < NUMPERFEVENTS; e++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = types[e];
+    attr.config = configs[e];
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // only the leader (cycles) starts disabled, the others follow it
+    attr.disabled = (e == PERF_CYCLES);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    myFds[e] = syscall(__NR_perf_event_open, &attr, 0, -1, myFds[PERF_CYCLES], 0);
+    if (myFds[e] < 0 && e == PERF_CYCLES) {
+      myError = strerror(errno);
+      return false;
+    }
+  }
+  return true;
+#else
+  myError = "perf events are only available on Linux";
+  return false;
+#endif
+}
+
+/* resets the counts and starts counting
+ */
+void PerfCounters::start() {
+#ifdef __linux__
+  if (!isOpen())
+    return;
+  ioctl(myFds[PERF_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(myFds[PERF_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+/* stops counting, and stores the count of each event in counts (-1 for
+ * an event that is not counted), scaled up if the events could only be
+ * counted part of the time
+ */
+void PerfCounters::stop(long long counts[NUMPERFEVENTS]) {
+  for (int e = 0; e < NUMPERFEVENTS; e++) {
+    counts[e] = -1;
+  }
+#ifdef __linux__
+  if (!isOpen())
+    return;
+  ioctl(myFds[PERF_CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  for (int e = 0; e < NUMPERFEVENTS; e++) {
+    // value, time enabled, time running
+    unsigned long long values[3];
+    if (myFds[e] < 0 || read(myFds[e], values, sizeof(values)) != sizeof(values))
+      continue;
+    if (values[2] == 0)
+      counts[e] = 0;
+    else if (values[2] < values[1])
+      counts[e] = (long long)((double)values[0] * values[1] / values[2]);
+    else
+      counts[e] = values[0];
+  }
+#endif
+}
+
+/* returns the name of event
+ */
+const char *PerfCounters::getName(int event) {
+  static const char *names[NUMPERFEVENTS] = {
+    "cycles", "instructions", "llc_misses", "branch_misses"
+  };
+  return names[event];
+}
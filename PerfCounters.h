@@ -0,0 +1,60 @@
+// Name: Maxine Xin
+#ifndef __PERFCOUNTERS_H__
+#define __PERFCOUNTERS_H__
+
+#include <string>
+
+using namespace std;
+
+// hardware events counted
+enum PerfEvent {
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_LLC_MISSES,
+  PERF_BRANCH_MISSES,
+  NUMPERFEVENTS
+};
+
+/* This class counts hardware events of the simulator itself (in user space)
+ * between start() and stop(), with perf_event_open on Linux. The events are
+ * opened as a group, so that they are counted over the same cycles; an
+ * event the processor does not have is left out (counted as -1), and if
+ * perf events are not permitted at all (e.g. in a container, or with a high
+ * perf_event_paranoid), open() fails and nothing is counted.
+ */
+class PerfCounters {
+  public:
+    PerfCounters();
+
+    /* closes the events
+     */
+    ~PerfCounters();
+
+    /* opens the events, and returns false (with the reason in getError())
+     * if none of them can be counted
+     */
+    bool open();
+
+    bool isOpen() { return myFds[PERF_CYCLES] >= 0; };
+    string getError() { return myError; };
+
+    /* resets the counts and starts counting
+     */
+    void start();
+
+    /* stops counting, and stores the count of each event in counts (-1 for
+     * an event that is not counted), scaled up if the events could only be
+     * counted part of the time
+     */
+    void stop(long long counts[NUMPERFEVENTS]);
+
+    /* returns the name of event
+     */
+    static const char *getName(int event);
+
+  private:
+    int myFds[NUMPERFEVENTS];  // -1 for an event not counted
+    string myError;
+};
+
+#endif
@@ -1,5 +1,12 @@
 // Name: Maxine Xin
 #include "Pipeline.h"
+#include "ReportWriter.h"
+#include "TraceWriter.h"
+
+#include <algorithm>
+
+// name of each stage in a pipeline diagram
+static const char *STAGE_NAMES[NUMSTAGES] = { "IF", "ID", "EX", "MEM", "WB" };
 
 /* default constructor of the Pipeline class, 
  * sets all entries in myStageEntry to myStageEmpty
@@ -15,6 +22,10 @@ Pipeline::Pipeline() {
 
   // set the name for this pipeline
   myName = "IDEAL";
+  myStallCause = STALL_STRUCTURAL;
+  myStallProducer = -1;
+  myTimelineFirst = 0;
+  myTimelineSize = 0;
 }
 
 /* destructor
@@ -25,37 +36,71 @@ Pipeline::~Pipeline() {}
  * gets and stores all the dependences of the instructions
  *
  */
-void Pipeline::initialize(vector<Instruction> instructions) {
+void Pipeline::initialize(const vector<Instruction> &instructions) {
   // go through the instructions, store them in the list,
   // and add them to myDepChecker 
   for (unsigned int i = 0; i < instructions.size(); i++) {
     myDepChecker.addInstruction(instructions[i]);
     myInstructions.push_back(instructions[i]);
+    myOpcodes.push_back(instructions[i].getOpcode());
+  }
+  myExeTimes.assign(myInstructions.size(), 0);
+  for (int cause = 0; cause < NUMSTALLCAUSES; cause++) {
+    myStalls[cause].assign(myInstructions.size(), 0);
   }
+  myStallProducers.assign(myInstructions.size(), -1);
 }
 
 /* models processing instructions in ideal pipeline datapaths,
  * compute execution time for each instruction and store the time
- * into each Instruction instance
+ * (see getExeTimes())
  *
  */
 void Pipeline::execute() {
-  list<Instruction>::iterator it; // keeps track of the inst in the last stage
-  it = myInstructions.begin();   
-    
-  unsigned int instNum = 0;       // keeps track of the # of the inst to be fetched 
-  int time = 0;
+  run(getEmptyState(), myInstructions.size());
+  return;
+}
+
+/* resumes the pipeline from state from, and simulates cycles until the
+ * instruction untilFetched has been fetched, or until every instruction
+ * has completed if untilFetched is not less than the number of instructions;
+ * the execution time of each instruction completed on the way is stored
+ * (and also appended to completed, if given), and the state reached
+ * is returned
+ *
+ */
+PipelineState Pipeline::run(const PipelineState &from, unsigned int untilFetched,
+                            vector<int> *completed) {
+  unsigned int instNum = from.nextFetch;  // keeps track of the # of the inst to be fetched 
+  int time = from.time;
+
+  // restore the stages, and find the oldest inst in the pipeline,
+  // which is the next one to leave the last stage
+  unsigned int oldest = instNum;
+  for (int st = 0; st < NUMSTAGES; st++) {
+    myStageEntry[st] = from.stageEntry[st];
+    if (myStageEntry[st] != myStageEmpty && (unsigned int)myStageEntry[st] < oldest)
+      oldest = myStageEntry[st];
+  }
+
+  unsigned int numInstructions = myInstructions.size();
+  unsigned int itIndex = min(oldest, numInstructions);  // the inst in the last stage
 
   // while loop will terminate when all instructions get processed and
-  // the last stage is finished for the last instruction
-  while (it != myInstructions.end()) {  
+  // the last stage is finished for the last instruction, or when
+  // the instruction untilFetched has been fetched
+  while (itIndex < numInstructions && instNum <= untilFetched) {  
+    bool stalledOnRAW = false;    // whether an inst stalled for a RAW in this cycle
     for (int st = NUMSTAGES - 1; st >= 0; st--) {
       if (st == NUMSTAGES - 1 && myStageEntry[st] != myStageEmpty) {
         // if in the last stage and it is not empty,
         // removes the instruction in that stage and sets 
         // its execution time 
-        (*it).setExeTime(time);
-        it++;
+        myExeTimes[itIndex] = time;
+        if (completed != NULL)
+          completed->push_back(time);
+        recordEntry(itIndex, NUMSTAGES, time);
+        itIndex++;
         myStageEntry[NUMSTAGES - 1] = myStageEmpty;
       }
 
@@ -66,7 +111,7 @@ void Pipeline::execute() {
         if (st == 0) {
           // if current stage if the first stage, and there is still instruction
           // to be fetched, fetch that instruction 
-          if (instNum < myInstructions.size()) {
+          if (instNum < numInstructions) {
             myStageEntry[st] = instNum;
             instNum++;
           }
@@ -75,11 +120,91 @@ void Pipeline::execute() {
           myStageEntry[st] = myStageEntry[st - 1];
           myStageEntry[st - 1] = myStageEmpty;
         }
+        if (myStageEntry[st] != myStageEmpty)
+          recordEntry(myStageEntry[st], st, time);
+      } else if (st != 0 && myStageEntry[st - 1] != myStageEmpty) {
+        // the inst in the previous stage stalls for this cycle
+        recordStall(myStageEntry[st - 1]);
+        stalledOnRAW = stalledOnRAW || (myStallCause == STALL_RAW);
+      } else if (st == 0 && myStallCause == STALL_JUMP && instNum < numInstructions) {
+        // the inst to be fetched waits for the destination of a jump; if the
+        // jump is held up behind a RAW stall, that stall is what it waits for
+        if (stalledOnRAW)
+          myStallCause = STALL_STRUCTURAL;
+        recordStall(instNum);
       }
     }
     time++;
   }
-  return;
+
+  // record the state reached
+  PipelineState reached;
+  for (int st = 0; st < NUMSTAGES; st++) {
+    reached.stageEntry[st] = myStageEntry[st];
+  }
+  reached.time = time;
+  reached.nextFetch = instNum;
+  return reached;
+}
+
+/* returns the state of the pipeline before the first cycle, 
+ * (no stage occupied, instruction 0 to be fetched)
+ */
+PipelineState Pipeline::getEmptyState() {
+  PipelineState empty;
+  for (int st = 0; st < NUMSTAGES; st++) {
+    empty.stageEntry[st] = myStageEmpty;
+  }
+  empty.time = 0;
+  empty.nextFetch = 0;
+  return empty;
+}
+
+/* returns a newly allocated, uninitialized pipeline of the same kind;
+ * the caller is responsible for deleting it
+ */
+Pipeline *Pipeline::createEmpty() {
+  return new Pipeline();
+}
+
+/* returns the stages that decide when the pipeline stalls; in an ideal
+ * pipeline, every result and jump destination is available right away
+ */
+PipelineConfig Pipeline::getConfig() {
+  PipelineConfig config;
+  config.operandNeeded = FETCH;
+  config.operandProducedMemory = FETCH;
+  config.operandProducedOther = FETCH;
+  config.forwarding = true;
+  config.jumpDestProduced = FETCH;
+  config.forwardPaths = FORWARD_BY_STAGES;
+  return config;
+}
+
+/* sets the execution time of each instruction, in order; used when the
+ * times were computed elsewhere (e.g. by a ChunkedSimulation)
+ */
+void Pipeline::setExeTimes(const vector<int> &times) {
+  for (unsigned int i = 0; i < times.size() && i < myExeTimes.size(); i++) {
+    myExeTimes[i] = times[i];
+  }
+}
+
+/* returns the bytes held by the pipeline: its instructions, their
+ * opcodes, stalls and timelines, and its dependence checker
+ */
+size_t Pipeline::getMemoryUsage() const {
+  size_t bytes = sizeof(*this) - sizeof(myDepChecker) + myDepChecker.getMemoryUsage();
+  bytes += MemoryAccount::objectListBytes(myInstructions) + MemoryAccount::vectorBytes(myExeTimes);
+  bytes += MemoryAccount::vectorBytes(myOpcodes);
+  for (int cause = 0; cause < NUMSTALLCAUSES; cause++) {
+    bytes += MemoryAccount::vectorBytes(myStalls[cause]);
+  }
+  bytes += MemoryAccount::vectorBytes(myStallProducers);
+  for (int st = 0; st <= NUMSTAGES; st++) {
+    bytes += MemoryAccount::vectorBytes(myTimeline[st]);
+  }
+  return bytes;
 }
 
 /* print out the RAW dependences among the list of instructions,
@@ -87,25 +212,196 @@ void Pipeline::execute() {
  *
  */
 void Pipeline::print() {
-  cout << myName << ": " << endl;
-  myDepChecker.printRAWDependences();      // ask myDepChecker to print out RAW dependences
-  cout << "Instr# \t CompletionTime \t Mnemonic " << endl;
-  list<Instruction>::iterator it;
-  int instIndex = 0;
-  int totalTime = 0;
+  ReportWriter report(cout, REPORT_TEXT);
+  report.writePipeline(this, true);
+}
 
-  // goes through the instructions and prints out their execution times
+/* charges lost cycles, by which an instruction that stalled raw cycles
+ * for a RAW and jump cycles for a jump delayed the completion of the
+ * instructions, to one cause each: to RAW up to raw, then to jumps up to
+ * jump, and the rest to structural hazards; adds them to lostByCause
+ * (indexed by StallCause)
+ */
+void Pipeline::chargeLostCycles(long long lost, long long raw, long long jump,
+                                long long *lostByCause) {
+  long long rawLost = min(lost, raw);
+  long long jumpLost = min(lost - rawLost, jump);
+  lostByCause[STALL_RAW] += rawLost;
+  lostByCause[STALL_JUMP] += jumpLost;
+  lostByCause[STALL_STRUCTURAL] += lost - rawLost - jumpLost;
+}
+
+/* records, in the following runs, the cycle each instruction from first
+ * to last (included) enters each stage, and the cycle it completes
+ */
+void Pipeline::recordTimeline(unsigned int first, unsigned int last) {
+  myTimelineFirst = first;
+  myTimelineSize = (last >= first) ? last - first + 1 : 0;
+  for (int st = 0; st <= NUMSTAGES; st++) {
+    myTimeline[st].assign(myTimelineSize, -1);
+  }
+}
+
+/* print out the pipeline diagram of the instructions recorded: one line
+ * per instruction, with the stage it is in at each cycle, and -- for
+ * each cycle it stalls in the same stage
+ */
+void Pipeline::printDiagram() {
+  const int CELL = 5;     // width of the column of each cycle
+  cout << myName << " pipeline diagram: " << "\n";
+
+  // only go through the instructions recorded, one line at a time
+  unsigned int numRecorded = 0;
+  while (numRecorded < myTimelineSize && myTimeline[FETCH][numRecorded] != -1) {
+    numRecorded++;
+  }
+  if (numRecorded == 0)
+    return;
+  int firstCycle = myTimeline[FETCH][0];
+  int lastCycle = myTimeline[NUMSTAGES][numRecorded - 1];
+  for (unsigned int i = 0; i < numRecorded; i++) {
+    lastCycle = max(lastCycle, myTimeline[NUMSTAGES][i]);
+  }
+
+  cout << "Instr# \t Mnemonic \t\t ";
+  for (int cycle = firstCycle; cycle < lastCycle; cycle++) {
+    string label = to_string(cycle);
+    cout << label << string(max(1, CELL - (int)label.length()), ' ');
+  }
+  cout << "\n";
+
+  list<Instruction>::iterator it = myInstructions.begin();
+  advance(it, min((unsigned int)myInstructions.size(), myTimelineFirst));
+  for (unsigned int i = 0; i < numRecorded && it != myInstructions.end(); i++, it++) {
+    string assembly = (*it).getAssembly();
+    cout << myTimelineFirst + i << "\t " << assembly 
+         << string(max(1, 24 - (int)assembly.length()), ' ');
+    for (int cycle = firstCycle; cycle < lastCycle; cycle++) {
+      // find the stage the instruction is in at this cycle, if any
+      string cell;
+      for (int st = 0; st < NUMSTAGES; st++) {
+        int leave = myTimeline[st + 1][i];
+        if (myTimeline[st][i] != -1 && myTimeline[st][i] <= cycle && (leave == -1 || cycle < leave)) 
+          cell = (cycle == myTimeline[st][i]) ? STAGE_NAMES[st] : "--";
+      }
+      cout << cell << string(CELL - cell.length(), ' ');
+    }
+    cout << "\n";
+  }
+}
+
+/* writes the instructions recorded to writer, as process pid: a track
+ * per stage with a slice for each instruction in it, and a flow for each
+ * RAW dependence between them, from the producer to the consumer entering
+ * EXECUTE
+ */
+void Pipeline::writeTrace(TraceWriter &writer, int pid) {
+  writer.nameProcess(pid, myName);
+  for (int st = 0; st < NUMSTAGES; st++) {
+    writer.nameTrack(pid, st, STAGE_NAMES[st]);
+  }
+
+  list<Instruction>::iterator it = myInstructions.begin();
+  advance(it, min((unsigned int)myInstructions.size(), myTimelineFirst));
+  for (unsigned int i = 0; i < myTimelineSize && it != myInstructions.end(); i++, it++) {
+    int instNum = myTimelineFirst + i;
+    string assembly = (*it).getAssembly();
+    for (int st = 0; st < NUMSTAGES; st++) {
+      int enter = myTimeline[st][i];
+      int leave = myTimeline[st + 1][i];
+      if (enter != -1 && leave != -1)
+        writer.addSlice(pid, st, assembly, enter, leave - enter, instNum);
+    }
+
+    // arrows from the producers recorded, which come before
+    int consumerStart = myTimeline[EXECUTE][i];
+    const vector<int> &producers = myDepChecker.getRAWProducers(instNum);
+    for (unsigned int p = 0; p < producers.size(); p++) {
+      unsigned int producer = producers[p] - myTimelineFirst;
+      if (producer >= myTimelineSize || consumerStart == -1 || myTimeline[EXECUTE][producer] == -1)
+        continue;
+      string name = "RAW " + DependencyChecker::getRegisterName(
+          myDepChecker.getRAWRegister(producers[p], instNum));
+      long long id = writer.addFlowStart(pid, EXECUTE, name, myTimeline[EXECUTE][producer]);
+      writer.addFlowFinish(pid, EXECUTE, id, name, consumerStart);
+    }
+  }
+}
+
+/* print out the cycles each instruction stalled and why (only for the
+ * instructions that stalled), the total for each cause, and the top
+ * producer -> consumer opcode pairs and registers by RAW stall cycles
+ */
+void Pipeline::printStalls(unsigned int top) {
+  const int NUMREGISTERS = DependencyChecker::REG_LO + 1;   // with HI and LO
+  vector<Opcode> opcodes;
+  opcodes.reserve(myInstructions.size());
+  list<Instruction>::iterator it;
   for (it = myInstructions.begin(); it != myInstructions.end(); it++) {
-    cout << instIndex << "\t" 
-         << (*it).getExeTime() << "\t\t\t" << "|"
-         << (*it).getAssembly()
-         << endl;
-    instIndex++;
-    totalTime = (*it).getExeTime();
-  }
-  cout << "Total time is " << totalTime << endl;
-  
-  return;
+    opcodes.push_back((*it).getOpcode());
+  }
+
+  // stall cycles for each (producer, consumer) opcode pair / register
+  vector<long long> pairStalls(UNDEFINED * UNDEFINED, 0);
+  vector<long long> registerStalls(NUMREGISTERS, 0);
+  long long totals[NUMSTALLCAUSES] = { 0 };
+
+  cout << myName << " stalls: " << "\n";
+  cout << "Instr# \t RAW \t Jump \t Structural \t Cause " << "\n";
+  for (unsigned int i = 0; i < opcodes.size(); i++) {
+    int raw = myStalls[STALL_RAW][i];
+    int jump = myStalls[STALL_JUMP][i];
+    int structural = myStalls[STALL_STRUCTURAL][i];
+    totals[STALL_RAW] += raw;
+    totals[STALL_JUMP] += jump;
+    totals[STALL_STRUCTURAL] += structural;
+    if (raw + jump + structural == 0)
+      continue;
+
+    cout << i << "\t " << raw << "\t " << jump << "\t " << structural << "\t\t ";
+    int producer = myStallProducers[i];
+    if (raw > 0 && producer != -1) {
+      int reg = myDepChecker.getRAWRegister(producer, i);
+      cout << "RAW on " << DependencyChecker::getRegisterName(reg) << " from " << producer;
+      pairStalls[opcodes[producer] * UNDEFINED + opcodes[i]] += raw;
+      if (reg >= 0 && reg < NUMREGISTERS)
+        registerStalls[reg] += raw;
+    } else if (jump > 0) {
+      cout << "jump";
+    } else {
+      cout << "structural";
+    }
+    cout << "\n";
+  }
+  cout << "Total stall cycles: " << totals[STALL_RAW] << " RAW, " << totals[STALL_JUMP] 
+       << " jump, " << totals[STALL_STRUCTURAL] << " structural" << "\n";
+
+  // sort the pairs and registers by stall cycles, most first
+  vector<pair<long long, int> > hottest;
+  for (unsigned int p = 0; p < pairStalls.size(); p++) {
+    if (pairStalls[p] > 0)
+      hottest.push_back(make_pair(-pairStalls[p], p));
+  }
+  sort(hottest.begin(), hottest.end());
+  cout << "Producer -> consumer \t RAW stall cycles " << "\n";
+  for (unsigned int h = 0; h < hottest.size() && h < top; h++) {
+    int p = hottest[h].second;
+    cout << myOpcodeTable.getInstName((Opcode)(p / UNDEFINED)) << " -> " 
+         << myOpcodeTable.getInstName((Opcode)(p % UNDEFINED)) << "\t\t " 
+         << -hottest[h].first << "\n";
+  }
+
+  hottest.clear();
+  for (int reg = 0; reg < NUMREGISTERS; reg++) {
+    if (registerStalls[reg] > 0)
+      hottest.push_back(make_pair(-registerStalls[reg], reg));
+  }
+  sort(hottest.begin(), hottest.end());
+  cout << "Register \t RAW stall cycles " << "\n";
+  for (unsigned int h = 0; h < hottest.size() && h < top; h++) {
+    cout << DependencyChecker::getRegisterName(hottest[h].second) << "\t\t " 
+         << -hottest[h].first << "\n";
+  }
 }
 
 /* given a stage index, returns true if the next instruction can be processed
@@ -115,5 +411,15 @@ void Pipeline::print() {
  */
 bool Pipeline::canMoveIntoStage(int st) {
   // returns whether the current stage is unoccupied
+  myStallCause = STALL_STRUCTURAL;
   return (myStageEntry[st] == myStageEmpty);
 }
+
+/* records cycles (one by default) instruction i stalled for, for
+ * myStallCause
+ */
+void Pipeline::recordStall(int i, int cycles) {
+  myStalls[myStallCause][i] += cycles;
+  if (myStallCause == STALL_RAW)
+    myStallProducers[i] = myStallProducer;
+}
@@ -11,6 +11,8 @@
 
 using namespace std;
 
+class TraceWriter;
+
 // enum of each stage
 enum Stage {
   FETCH,
@@ -21,6 +23,57 @@ enum Stage {
   NUMSTAGES 
 };
 
+// why an instruction could not move into the next stage in a cycle
+enum StallCause {
+  STALL_RAW,          // an operand it needs is not available yet
+  STALL_JUMP,         // it cannot be fetched until the destination of a jump is known
+  STALL_STRUCTURAL,   // the next stage is still occupied
+  NUMSTALLCAUSES
+};
+
+// the paths a result can be forwarded along, to an instruction reading it
+// in DECODE and needing it as it enters EXECUTE; each bit is the stage the
+// producer is in (past the one computing the result) when it is forwarded
+enum ForwardPath {
+  FORWARD_EX_EX = 1 << MEMORY,       // from EX/MEM (the producer in MEMORY)
+  FORWARD_MEM_EX = 1 << WRITEBACK,   // from MEM/WB (the producer in WRITEBACK)
+  FORWARD_WB_ID = 1 << NUMSTAGES,    // the register file written in the first half
+                                     // of WRITEBACK, and read in the second half
+  ALLFORWARDPATHS = FORWARD_EX_EX | FORWARD_MEM_EX | FORWARD_WB_ID,
+  FORWARD_BY_STAGES = -1             // no set of paths, only the stages
+};
+
+/* A snapshot of the pipeline taken between two cycles. Together with the
+ * instructions, it is all that is needed to resume the simulation.
+ */
+struct PipelineState {
+  int stageEntry[NUMSTAGES];   // number of the inst in each stage, -1 if unoccupied
+  int time;                    // the cycle about to be simulated
+  unsigned int nextFetch;      // number of the next inst to be fetched
+};
+
+/* The stages that decide when a pipeline stalls. An instruction that needs
+ * the result of an instruction d before it cannot leave stage operandNeeded
+ * until that result is available: in the stage it is produced in with
+ * forwarding, or once it has been written back from that stage without.
+ * No instruction is fetched while a jump is between FETCH (excluded) and
+ * the stage its destination is produced in (included).
+ *
+ * With a set of forwardPaths instead, operandNeeded is the stage the
+ * registers are read in, and the result of d is available to the
+ * instruction leaving it once d is past the stage it is produced in, and
+ * in a stage one of the paths forwards it from, or written back (in the
+ * same cycle only with FORWARD_WB_ID).
+ */
+struct PipelineConfig {
+  int operandNeeded;           // stage where operand value is needed
+  int operandProducedMemory;   // stage where operand value is produced for memory insts
+  int operandProducedOther;    // stage where operand value is produced for other insts
+  bool forwarding;             // true if the value is forwarded as soon as it is produced
+  int jumpDestProduced;        // stage where the destination of a jump is produced
+  int forwardPaths;            // set of ForwardPath, or FORWARD_BY_STAGES
+};
+
 /* This class models the Pipeline. Given a list of instances of Instructions,
  * the Pipeline class models processing each instruction in an ideal Pipeline
  * (ignoring all stalls), and compute execution time for each instruction.
@@ -43,14 +96,77 @@ class Pipeline {
      * gets and stores all the dependences of the instructions
      *
      */
-    void initialize(vector<Instruction> instructions);
+    void initialize(const vector<Instruction> &instructions);
 
     /* models processing instructions in ideal pipeline datapaths,
      * compute execution time for each instruction and store the time
-     * into each Instruction instance
+     * (see getExeTimes())
+     *
+     */
+    virtual void execute();
+
+    /* resumes the pipeline from state from, and simulates cycles until the
+     * instruction untilFetched has been fetched, or until every instruction
+     * has completed if untilFetched is not less than the number of instructions;
+     * the execution time of each instruction completed on the way is stored
+     * (and also appended to completed, if given), and the state reached
+     * is returned
      *
      */
-    void execute();
+    PipelineState run(const PipelineState &from, unsigned int untilFetched,
+                      vector<int> *completed = NULL);
+
+    /* returns the state of the pipeline before the first cycle, 
+     * (no stage occupied, instruction 0 to be fetched)
+     */
+    PipelineState getEmptyState();
+
+    /* returns a newly allocated, uninitialized pipeline of the same kind;
+     * the caller is responsible for deleting it
+     */
+    virtual Pipeline *createEmpty();
+
+    /* returns the stages that decide when the pipeline stalls; in an ideal
+     * pipeline, every result and jump destination is available right away
+     */
+    virtual PipelineConfig getConfig();
+
+    /* returns the number of instructions stored in the pipeline, and the
+     * instructions themselves
+     */
+    unsigned int getNumInstructions() { return myInstructions.size(); };
+    const list<Instruction> &getInstructions() { return myInstructions; };
+
+    /* returns the execution time of each instruction, in order
+     */
+    const vector<int> &getExeTimes() { return myExeTimes; };
+
+    /* sets the execution time of each instruction, in order; used when the
+     * times were computed elsewhere (e.g. by a ChunkedSimulation)
+     */
+    void setExeTimes(const vector<int> &times);
+
+    /* returns the dependence checker holding the dependences of the instructions
+     */
+    DependencyChecker *getDependencyChecker() { return &myDepChecker; };
+
+    /* returns the bytes held by the pipeline: its instructions, their
+     * opcodes, stalls and timelines, and its dependence checker
+     */
+    virtual size_t getMemoryUsage() const;
+
+    /* returns the name of the pipeline
+     */
+    string getName() { return myName; };
+
+    /* returns the number of instructions issued per cycle, at most
+     */
+    virtual unsigned int getWidth() { return 1; };
+
+    /* returns the cycles instruction i takes to go through the stages when
+     * nothing holds it up, one per stage
+     */
+    virtual unsigned int getIdealLatency(unsigned int i) { return NUMSTAGES; };
 
     /* print out the RAW dependences among the list of instructions,
      * followed by each instruction and the corresponding execution time
@@ -58,6 +174,52 @@ class Pipeline {
      */
     void print();
 
+    /* returns the number of cycles each instruction stalled for the given
+     * cause, and the last instruction each one stalled on because of a RAW
+     * dependence (-1 if none), as recorded by the runs since initialize()
+     */
+    const vector<int> &getStalls(StallCause cause) { return myStalls[cause]; };
+    const vector<int> &getStallProducers() { return myStallProducers; };
+
+    /* charges lost cycles, by which an instruction that stalled raw cycles
+     * for a RAW and jump cycles for a jump delayed the completion of the
+     * instructions, to one cause each: to RAW up to raw, then to jumps up to
+     * jump, and the rest to structural hazards; adds them to lostByCause
+     * (indexed by StallCause)
+     */
+    static void chargeLostCycles(long long lost, long long raw, long long jump,
+                                 long long *lostByCause);
+
+    /* records, in the following runs, the cycle each instruction from first
+     * to last (included) enters each stage, and the cycle it completes
+     */
+    void recordTimeline(unsigned int first, unsigned int last);
+
+    /* returns the cycle each instruction recorded entered stage st (or
+     * completed, for st = NUMSTAGES), -1 if it has not yet; entry i is for
+     * instruction first + i
+     */
+    const vector<int> &getTimeline(int st) { return myTimeline[st]; };
+
+    /* print out the pipeline diagram of the instructions recorded: one line
+     * per instruction, with the stage it is in at each cycle, and -- for
+     * each cycle it stalls in the same stage
+     */
+    void printDiagram();
+
+    /* writes the instructions recorded to writer, as process pid: a track
+     * per stage with a slice for each instruction in it, and a flow for each
+     * RAW dependence between them, from the producer to the consumer entering
+     * EXECUTE
+     */
+    void writeTrace(TraceWriter &writer, int pid);
+
+    /* print out the cycles each instruction stalled and why (only for the
+     * instructions that stalled), the total for each cause, and the top
+     * producer -> consumer opcode pairs and registers by RAW stall cycles
+     */
+    void printStalls(unsigned int top);
+
   private:
 
     /* given a Stage index, returns true if the next instruction can be processed
@@ -66,11 +228,25 @@ class Pipeline {
      *
      */
     virtual bool canMoveIntoStage(int st);
-    
 
   protected:
+    /* records cycles (one by default) instruction i stalled for, for
+     * myStallCause
+     */
+    void recordStall(int i, int cycles = 1);
+
+    /* records the cycle time instruction i entered stage st (or completed,
+     * for st = NUMSTAGES), if its timeline is recorded
+     */
+    void recordEntry(unsigned int i, int st, int time) {
+      if (i - myTimelineFirst < myTimelineSize)
+        myTimeline[st][i - myTimelineFirst] = time;
+    };
+
     string myName;                     // name of the pipeline 
     list<Instruction> myInstructions;  // stores instructions
+    vector<int> myExeTimes;            // execution time of each of them, by number
+    vector<Opcode> myOpcodes;          // opcode of each of them, looked up by number
     DependencyChecker myDepChecker;    // stores dependences
     OpcodeTable myOpcodeTable;         // stores info of opcodes
     int myStageEntry[NUMSTAGES];       // int array stores the number representing
@@ -78,6 +254,16 @@ class Pipeline {
                                        // to a stage; stores -1 if that stage is
                                        // not processing any instruction
     int myStageEmpty;                  // will be set to -1, indicates the a stage is unoccupied 
+    StallCause myStallCause;           // set by canMoveIntoStage() when it returns false,
+    int myStallProducer;               // along with the producer for a RAW
+
+  private:
+    vector<int> myStalls[NUMSTALLCAUSES];  // cycles each inst stalled, for each cause
+    vector<int> myStallProducers;          // last inst each inst stalled on for a RAW
+    unsigned int myTimelineFirst;          // first inst whose timeline is recorded,
+    unsigned int myTimelineSize;           // and the number of insts recorded (0 if none)
+    vector<int> myTimeline[NUMSTAGES + 1]; // cycle each of them entered each stage,
+                                           // then completed
    
 };
 
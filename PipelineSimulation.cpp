@@ -2,10 +2,32 @@
 #include "Pipeline.h"
 #include "StallPipeline.h"
 #include "ForwardingPipeline.h"
+#include "SuperscalarPipeline.h"
+#include "OutOfOrderPipeline.h"
 #include "ASMParser.h"
 #include "BinaryParser.h"
+#include "ChunkedSimulation.h"
+#include "MemoizedSimulation.h"
+#include "IncrementalSimulation.h"
+#include "SampledSimulation.h"
+#include "StreamingSimulation.h"
+#include "MultiCoreSimulation.h"
+#include "IntervalEstimator.h"
+#include "DependenceGraph.h"
+#include "TraceWriter.h"
+#include "ReportWriter.h"
+#include "ResultsFile.h"
+#include "Profiler.h"
+#include "MemoryAccount.h"
+#include "DataCache.h"
+#include "AddressModel.h"
+#include "BranchPredictor.h"
 
+#include <chrono>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <vector>
 using namespace std;
 
@@ -16,14 +38,131 @@ using namespace std;
  * stall pipeline, and forwarding pipeline will be computed and printed out to
  * stdout.
  *
+ * usage: PIPESIM <file> [-chunks N] [-warmup W] [-memo] [-fastforward] [-edit]
+ *                       [-sample S] [-samplesize U] [-seed X] [-estimate] [-validate]
+ *                       [-ilp] [-graph G] [-stalls] [-diagram A B] [-trace T]
+ *                       [-format F] [-results R] [-profile P] [-counters]
+ *                       [-memory] [-memorybudget B] [-width W] [-memports M]
+ *                       [-multipliers K] [-stages L] [-latency L] [-pipelined U]
+ *                       [-ooo] [-rob R] [-rs S] [-l1d C] [-l1i C] [-l2 C]
+ *                       [-memlatency M] [-fetchqueue Q] [-predictor P] [-btb N]
+ *                       [-forward F] [-forwardreport] [-multicore T] [-bus B]
+ *                       [-arbitration A] [-busfetch]
+ *   -chunks N: splits the instructions into N chunks simulated in parallel
+ *   -warmup W: number of instructions simulated before each chunk
+ *   -memo: simulates with memoized pipeline state transitions (every cycle
+ *          of a pipeline that never stalls, or of fewer instructions than
+ *          MemoizedSimulation::MINMEMOIZED, being simulated instead)
+ *   -fastforward: same as -memo, also fast-forwarding steady-state loops, and
+ *                 reports the speedup over simulating every cycle
+ *   -edit: after printing, reads edits of the instructions from stdin, and
+ *          updates the execution times after each of them
+ *   -sample S: only simulates S units of the instructions (warm-up W before
+ *              each), and prints out the estimated total time of each pipeline
+ *   -samplesize U: number of instructions in each unit
+ *   -seed X: picks the units at random with seed X instead of evenly spread
+ *   -estimate: prints out the total time of each pipeline estimated from
+ *              histograms of the RAW dependence distances, without simulating
+ *   -validate: with -sample or -estimate, also simulates all instructions, and
+ *              prints out the error of the estimate and the speedup
+ *   -ilp: also prints out the critical path and the available ILP of the
+ *         dependence graph of the instructions
+ *   -graph G: also writes the dependence graph of the instructions to file G
+ *   -stalls: also prints out the stall cycles of each instruction in each
+ *            pipeline and their cause, and the hottest opcode pairs and registers
+ *   -diagram A B: also prints out the pipeline diagram of instructions A to B
+ *                 in each pipeline
+ *   -trace T: also writes the stages each instruction went through in each
+ *             pipeline to file T, in the Chrome trace event format (only
+ *             instructions A to B with -diagram)
+ *   -format F: prints out the report of each pipeline as text (default), csv,
+ *              jsonl, or summary (totals only)
+ *   -results R: also writes the instruction number, opcode, and completion
+ *               time and stall cycles in each pipeline of each instruction
+ *               to file R, as a columnar binary file (see ResultsFile.h)
+ *   -profile P: prints out the time and throughput of each phase to stderr
+ *               if P is -, or writes them as JSON to file P (only when built
+ *               with make PROFILE=1)
+ *   -counters: with -profile, also counts the cycles, instructions, last
+ *              level cache misses and branch misses of each phase (only
+ *              timing the phases if perf events are not permitted)
+ *   -memory: also prints out the bytes held by each component (parser,
+ *            instructions, each pipeline and its dependences, buffers) to stderr
+ *   -memorybudget B: if the memory projected for simulating all pipelines is
+ *                    more than B bytes (k, m or g for powers of 1024), simulates
+ *                    each of them in windows of instructions instead, and only
+ *                    prints out the totals (unless -stalls, -diagram, -trace,
+ *                    -results or -edit need every instruction kept)
+ *   -width W: simulates each pipeline issuing up to W instructions per cycle
+ *             instead (see SuperscalarPipeline.h)
+ *   -memports M: with -width, number of memory ports (default 1)
+ *   -multipliers K: with -width, number of multipliers (default 1)
+ *   -stages L: cycles every instruction spends in each stage listed, e.g.
+ *              ex=3,mem=2 (if, id, ex, mem, wb; default 1)
+ *   -latency L: cycles the instructions of each opcode listed spend in
+ *               EXECUTE, or MEMORY for lb, e.g. mult=4,lb=3 (default 1)
+ *   -pipelined U: functional units listed (mem, mult) take a new instruction
+ *                 every cycle instead of one at a time
+ *   -ooo: also simulates an out-of-order pipeline (of width W with -width),
+ *         and prints out its IPC, how often its ROB and reservation
+ *         stations were full, and how long instructions waited in them for
+ *         their operands and for an issue slot to stderr (see
+ *         OutOfOrderPipeline.h)
+ *   -rob R: with -ooo, number of reorder buffer entries (default 32)
+ *   -rs S: with -ooo, number of reservation stations (default 16, at most 64)
+ *   -l1d C: each load spends in MEMORY the cycles an L1 data cache C takes
+ *           to serve it, given as size (k, m or g for powers of 1024),
+ *           associativity, line size, replacement policy (lru, fifo or
+ *           random) and hit latency, e.g. 32k,4,64,lru,1, and its hit rate
+ *           and MPKI are printed out to stderr; the addresses are annotated
+ *           on the loads (e.g. lb $1, 4($2) # @0x10010004) or modeled
+ *           (see AddressModel.h); not for the -ooo pipeline
+ *   -l1i C: fetching an instruction that misses in an I-cache C (given as
+ *           for -l1d) is held up for the cycles of the miss; the address of
+ *           each instruction follows from the one before it and the jumps
+ *   -l2 C: with -l1d or -l1i, an L2 cache C behind the L1 ones
+ *   -memlatency M: with -l1d or -l1i, cycles the memory takes after the
+ *                  last cache misses (default 100)
+ *   -fetchqueue Q: a fetch queue of Q entries between FETCH and DECODE, to
+ *                  fetch ahead while the back end stalls
+ *   with -l1i or -fetchqueue, the cycles each in-order pipeline was front-
+ *   end / back-end bound are printed out to stderr
+ *   -predictor P: jumps and branches (beq, taken if annotated # T) are
+ *                 predicted at fetch by P (nottaken, bimodal:N, gshare:N:H
+ *                 or btb:N, see BranchPredictor.h); fetching only waits for
+ *                 the destination of those mispredicted (or predicted taken
+ *                 without a destination from a BTB), and how many were
+ *                 mispredicted is printed out to stderr, then, for each
+ *                 pipeline, the cycles its fetching waited for them
+ *   -btb N: a branch target buffer of N entries gives the destinations of
+ *           the branches predicted taken (on its own, it predicts too)
+ *   -forward F: also simulates a forwarding pipeline that only forwards the
+ *               results along the paths listed (exex, memex and wbid, the
+ *               register file written and read in the same cycle; or all,
+ *               or none), e.g. exex,wbid
+ *   -forwardreport: also simulates that pipeline (all paths, unless -forward
+ *                   is given) with each set of the paths, and prints out
+ *                   the total time of each and the cycles each path saves
+ *                   to stderr
+ *   -multicore T: instead, simulates the file and each trace listed (e.g.
+ *                 b.asm,c.asm) on a core of its own, in lockstep, with their
+ *                 loads sharing a memory bus, and prints out the total time
+ *                 and throughput of each core and of all of them, for each
+ *                 pipeline (see MultiCoreSimulation.h)
+ *   -bus B: with -multicore, transfers the bus makes per cycle (default 1)
+ *   -arbitration A: with -multicore, the core the bus serves first, the one
+ *                   after the last one served (roundrobin, the default) or
+ *                   the lowest numbered one (fixed)
+ *   -busfetch: with -multicore, each fetch also needs a transfer on the bus
+ *
  */
 
 // This methods reads in a filename, and call the ASMParser to check the syntax
 // correctness of that file(containing MIPS assembly instructions); 
 // If the file is syntactically correct, will return a vector of instructions
 // associated with the read in file; otherwise, an error message will be
-// printed out
-vector<Instruction> getInstFromASMFile(string filename) {
+// printed out; the bytes the parser held are added to account, if given
+vector<Instruction> getInstFromASMFile(string filename, MemoryAccount *account) {
   vector<Instruction> instructions;
   Instruction i;
 
@@ -40,6 +179,8 @@ vector<Instruction> getInstFromASMFile(string filename) {
     instructions.push_back(i);
     i = aParser -> getNextInstruction();
   }
+  if (account != NULL)
+    account -> add("ASMParser", aParser -> getMemoryUsage(), false);
   delete aParser;
   
   return instructions;
@@ -50,8 +191,8 @@ vector<Instruction> getInstFromASMFile(string filename) {
 // encodings);
 // If the file is syntactically correct, will return a vector of instructions
 // associated with the read in file; otherwise, an error message will be
-// printed out
-vector<Instruction> getInstFromBinaryFile(string filename) {
+// printed out; the bytes the parser held are added to account, if given
+vector<Instruction> getInstFromBinaryFile(string filename, MemoryAccount *account) {
   vector<Instruction> instructions;
   Instruction i;
 
@@ -66,11 +207,484 @@ vector<Instruction> getInstFromBinaryFile(string filename) {
     instructions.push_back(i);
     i = bParser -> getNextInstruction();
   }
+  if (account != NULL)
+    account -> add("BinaryParser", bParser -> getMemoryUsage(), false);
   delete bParser;
 
   return instructions;
 }
 
+// This method runs the instructions through the caches in program order:
+// the fetch of each one through the I-cache l1i and each load through the
+// data cache l1d (either may be NULL, and both may be in front of the same
+// L2); it stores the cycles each instruction spends in MEMORY into
+// memoryCycles (0 for the other instructions, which keep those of their
+// opcode), and the cycles an I-cache miss holds up fetching each one into
+// fetchCycles (0 for a hit); the number of loads whose address was
+// annotated is printed out to stderr
+void runCaches(const vector<Instruction> &instructions, DataCache *l1d, DataCache *l1i,
+               vector<unsigned int> &memoryCycles, vector<unsigned int> &fetchCycles) {
+  AddressModel addressModel;
+  unsigned int numAnnotated;
+  vector<uint32_t> addresses = addressModel.getAddresses(instructions, numAnnotated);
+  vector<uint32_t> fetchAddresses = AddressModel::getFetchAddresses(instructions);
+  memoryCycles.assign(l1d != NULL ? instructions.size() : 0, 0);
+  fetchCycles.assign(l1i != NULL ? instructions.size() : 0, 0);
+  OpcodeTable opcodeTable;
+  unsigned int numLoads = 0;
+  for (unsigned int i = 0; i < instructions.size(); i++) {
+    if (l1i != NULL)
+      fetchCycles[i] = l1i -> access(fetchAddresses[i]) - l1i -> getHitLatency();
+    if (l1d != NULL && opcodeTable.isIMMMemory(instructions[i].getOpcode())) {
+      memoryCycles[i] = l1d -> access(addresses[i]);
+      numLoads++;
+    }
+  }
+  if (l1d != NULL)
+    cerr << "Data caches: " << numLoads << " loads, " << numAnnotated 
+         << " with annotated addresses, the others modeled" << endl;
+}
+
+// This method runs the jumps and branches of instructions through predictor
+// and btb (either may be NULL) in program order, and returns which of them
+// were predicted right at fetch: in the direction they went and, if taken,
+// with their destination from btb; how many were mispredicted is printed
+// out to stderr
+vector<bool> runPredictor(const vector<Instruction> &instructions, BranchPredictor *predictor,
+                          BranchPredictor *btb) {
+  vector<uint32_t> pcs = AddressModel::getFetchAddresses(instructions);
+  vector<bool> predicted(instructions.size(), false);
+  OpcodeTable opcodeTable;
+  // the direction comes from the predictor, or else from the BTB alone
+  BranchPredictor *direction = (predictor != NULL) ? predictor : btb;
+  // and the destinations from the BTB, or else from the predictor, if it
+  // is one (-predictor btb:N)
+  BranchPredictor *targets = (btb != NULL) ? btb : predictor;
+  long long numBranches = 0;
+  long long numConditional = 0;
+  long long numMispredicted = 0;
+  long long numNoTarget = 0;
+  for (unsigned int i = 0; i < instructions.size(); i++) {
+    Opcode op = instructions[i].getOpcode();
+    if (!opcodeTable.isIMMLabel(op))
+      continue;
+    numBranches++;
+    if (opcodeTable.isBranch(op))
+      numConditional++;
+    bool taken = AddressModel::isTaken(instructions[i]);
+    uint32_t target = AddressModel::getTarget(instructions[i], pcs[i]);
+    uint32_t predictedTarget = 0;
+    bool hasTarget = targets -> getTarget(pcs[i], predictedTarget) && predictedTarget == target;
+    if (direction -> predict(pcs[i]) != taken)
+      numMispredicted++;
+    else if (taken && !hasTarget)
+      numNoTarget++;
+    else
+      predicted[i] = true;
+    if (predictor != NULL)
+      predictor -> update(pcs[i], taken, target);
+    // behind a predictor, the BTB only holds destinations, so a branch not
+    // taken this time keeps its entry
+    if (btb != NULL && (taken || predictor == NULL))
+      btb -> update(pcs[i], taken, target);
+  }
+  cerr << "Branch prediction (" << (predictor != NULL ? predictor -> getName() : "")
+       << (predictor != NULL && btb != NULL ? ", " : "") << (btb != NULL ? btb -> getName() : "")
+       << "): " << numBranches << " jumps and branches (" << numConditional << " conditional), "
+       << numMispredicted << " mispredicted (" 
+       << (numBranches > 0 ? 100.0 * numMispredicted / numBranches : 0) << "%, "
+       << (instructions.empty() ? 0 : 1000.0 * numMispredicted / instructions.size()) << " MPKI), "
+       << numNoTarget << " taken without a destination at fetch" << endl;
+  return predicted;
+}
+
+// This method prints out to stderr, for pipeline, which has run with the
+// jumps and branches predicted right at fetch given by predicted, how many
+// were not, and the cycles fetching waited for them in it (each pipeline
+// resolving them in its own time)
+void reportMispredictions(Pipeline *pipeline, const vector<bool> &predicted) {
+  const list<Instruction> &instructions = pipeline -> getInstructions();
+  const vector<int> &jumpStalls = pipeline -> getStalls(STALL_JUMP);
+  OpcodeTable opcodeTable;
+  long long numMispredicted = 0;
+  long long numCycles = 0;
+  unsigned int i = 0;
+  for (list<Instruction>::const_iterator it = instructions.begin(); it != instructions.end();
+       it++, i++) {
+    if (opcodeTable.isIMMLabel((*it).getOpcode()) && (i >= predicted.size() || !predicted[i]))
+      numMispredicted++;
+    if (i < jumpStalls.size())
+      numCycles += jumpStalls[i];
+  }
+  cerr << pipeline -> getName() << ": " << numMispredicted
+       << " jumps and branches not predicted at fetch, fetching waited " << numCycles
+       << " cycles for them (" << (numMispredicted > 0 ? (double)numCycles / numMispredicted : 0)
+       << " per one)" << endl;
+}
+
+// This method simulates the instructions in a pipeline like pipeline with
+// each set of the forwarding paths, and prints out the total time with each
+// to stderr, then the cycles each path saves: alone, added to all the
+// others, and on average over the sets without it
+void reportForwardPaths(SuperscalarPipeline *pipeline, const vector<Instruction> &instructions) {
+  const int NUMPATHS = 3;
+  const int paths[NUMPATHS] = { FORWARD_EX_EX, FORWARD_MEM_EX, FORWARD_WB_ID };
+  const int numSets = 1 << NUMPATHS;
+
+  // set k holds path p if bit p of k is set
+  vector<int> totalTimes(numSets, 0);
+  cerr << "Forwarding paths (total time with each set):" << endl;
+  for (int k = 0; k < numSets; k++) {
+    int set = 0;
+    for (int p = 0; p < NUMPATHS; p++) {
+      if (k & (1 << p))
+        set |= paths[p];
+    }
+    SuperscalarPipeline *subset = (SuperscalarPipeline *)pipeline -> createEmpty();
+    subset -> setForwardPaths(set);
+    subset -> initialize(instructions);
+    subset -> execute();
+    vector<int> exeTimes = subset -> getExeTimes();
+    totalTimes[k] = exeTimes.empty() ? 0 : exeTimes.back();
+    delete subset;
+    cerr << ForwardingPipeline::getPathsName(set) << ": " << totalTimes[k] << endl;
+  }
+
+  for (int p = 0; p < NUMPATHS; p++) {
+    int bit = 1 << p;
+    long long sum = 0;
+    for (int k = 0; k < numSets; k++) {
+      if (!(k & bit))
+        sum += totalTimes[k] - totalTimes[k | bit];
+    }
+    cerr << ForwardingPipeline::getPathsName(paths[p]) << " saves " 
+         << totalTimes[0] - totalTimes[bit] << " cycles alone, "
+         << totalTimes[(numSets - 1) & ~bit] - totalTimes[numSets - 1] << " with the others, "
+         << (double)sum / (numSets / 2) << " on average" << endl;
+  }
+}
+
+// This method reads in the instructions of a file, of MIPS assembly
+// instructions if its name ends in asm, or else binary encodings
+vector<Instruction> getInstFromFile(string filename, MemoryAccount *account) {
+  if (filename.size() >= 3 && filename.compare(filename.size() - 3, 3, "asm") == 0)
+    return getInstFromASMFile(filename, account);
+  return getInstFromBinaryFile(filename, account);
+}
+
+// This method simulates the instructions of each trace (named by filenames)
+// on a core of its own, all sharing a bus, with the cores stalling as each
+// pipeline does, and prints out the instructions, total time, throughput
+// and cycles waiting for the bus of each core, then of all of them, with
+// how busy the bus was
+void simulateCores(vector<Pipeline*> &pipelinePtrs, const vector<vector<Instruction> > &traces,
+                   const vector<string> &filenames, MultiCoreSimulation &multiCoreSim,
+                   Profiler *profiler) {
+  long long numInstructions = 0;
+  for (unsigned int c = 0; c < traces.size(); c++) {
+    numInstructions += traces[c].size();
+  }
+  PROFILE_BEGIN(profiler, "dependences", "cores");
+  multiCoreSim.initialize(traces);
+  PROFILE_END(profiler, numInstructions, 0);
+
+  for (unsigned int i = 0; i < pipelinePtrs.size(); i++) {
+    PROFILE_BEGIN(profiler, "simulation", pipelinePtrs[i] -> getName());
+    multiCoreSim.execute(pipelinePtrs[i] -> getConfig());
+    PROFILE_END(profiler, numInstructions, multiCoreSim.getTotalTime());
+
+    cout << pipelinePtrs[i] -> getName() << " on " << multiCoreSim.getNumCores() << " cores:" << endl;
+    for (unsigned int c = 0; c < multiCoreSim.getNumCores(); c++) {
+      long long totalTime = multiCoreSim.getTotalTime(c);
+      cout << "Core " << c << " (" << filenames[c] << "): " << multiCoreSim.getNumInstructions(c)
+           << " instructions, total time " << totalTime << ", IPC "
+           << (totalTime > 0 ? (double)multiCoreSim.getNumInstructions(c) / totalTime : 0)
+           << ", " << multiCoreSim.getNumBusStalls(c) << " bus stall cycles" << endl;
+    }
+    long long totalTime = multiCoreSim.getTotalTime();
+    cout << "All cores: " << numInstructions << " instructions, total time " << totalTime
+         << ", IPC " << (totalTime > 0 ? (double)numInstructions / totalTime : 0) << ", "
+         << multiCoreSim.getNumTransfers() << " bus transfers (bus busy "
+         << (totalTime > 0 ? 100.0 * multiCoreSim.getNumTransfers()
+                             / (multiCoreSim.getBusWidth() * totalTime) : 0)
+         << "%)" << endl;
+    if (i != pipelinePtrs.size() - 1)
+      cout << endl;
+  }
+}
+
+// This method prints out the phases profiler timed to stderr if filename is
+// -, or writes them as JSON to file filename, and deletes profiler (if any)
+void writeProfile(Profiler *profiler, string filename) {
+  if (profiler == NULL)
+    return;
+  if (filename == "-") {
+    profiler -> writeText(cerr);
+  } else {
+    ofstream out(filename.c_str());
+    if (!out) {
+      cerr << "Cannot write profile to " << filename << endl;
+      exit(1);
+    }
+    profiler -> writeJSON(out);
+  }
+  delete profiler;
+}
+
+// This method simulates all the instructions in pipeline, and prints out the
+// actual total time, the error of estimate, and the speedup of computing the
+// estimate in estimateSeconds instead
+void validateEstimate(Pipeline *pipeline, vector<Instruction> &instructions,
+                      double estimate, double estimateSeconds) {
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  pipeline -> initialize(instructions);
+  pipeline -> execute();
+  chrono::duration<double> fullTime = chrono::steady_clock::now() - start;
+  vector<int> exeTimes = pipeline -> getExeTimes();
+  int actual = exeTimes.empty() ? 0 : exeTimes.back();
+  cout << pipeline -> getName() << ": Actual total time is " << actual;
+  if (actual > 0) 
+    cout << " (error " << (estimate - actual) * 100 / actual << "%)";
+  cout << endl;
+  cerr << pipeline -> getName() << ": estimated in " << estimateSeconds 
+       << "s, simulated in full in " << fullTime.count() << "s";
+  if (estimateSeconds > 0)
+    cerr << " (" << fullTime.count() / estimateSeconds << "x speedup)";
+  cerr << endl;
+}
+
+// This method estimates the total time of the instructions in each pipeline
+// with a SampledSimulation, and prints it out with its confidence interval;
+// if validate is true, the instructions are also simulated in full, and the
+// actual total time, the error and the speedup are printed out as well
+void sampleInstructions(vector<Pipeline*> &pipelinePtrs, vector<Instruction> &instructions,
+                        SampledSimulation &sampledSim, bool validate) {
+  for (unsigned int i = 0; i < pipelinePtrs.size(); i++) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    sampledSim.execute(pipelinePtrs[i], instructions);
+    chrono::duration<double> sampledTime = chrono::steady_clock::now() - start;
+
+    // the times are in cycles, printed without decimals rather than in
+    // scientific notation
+    ios::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+    cout << pipelinePtrs[i] -> getName() << ": Estimated total time is " << fixed
+         << setprecision(0) << sampledSim.getTotalTime() << " +- " << sampledSim.getConfidence();
+    cout.flags(flags);
+    cout.precision(precision);
+    cout << " (95% confidence), CPI " << sampledSim.getCPI() << endl;
+    if (sampledSim.getNumSamples() == 0)
+      cerr << pipelinePtrs[i] -> getName() << ": no samples, all " << instructions.size()
+           << " instructions simulated in full (sampling would not save anything)" << endl;
+    else
+      cerr << pipelinePtrs[i] -> getName() << ": " << sampledSim.getNumSamples() 
+           << " samples, " << sampledSim.getNumSimulated() << " of " << instructions.size()
+           << " instructions simulated" << endl;
+    if (validate)
+      validateEstimate(pipelinePtrs[i], instructions, sampledSim.getTotalTime(), 
+                       sampledTime.count());
+  }
+}
+
+// This method estimates the total time of the instructions in each pipeline
+// with an IntervalEstimator, from a single pass over the instructions, and
+// prints it out; if validate is true, the instructions are also simulated 
+// in full, and the actual total time, the error and the speedup are printed
+// out as well
+void estimateInstructions(vector<Pipeline*> &pipelinePtrs, vector<Instruction> &instructions,
+                          bool validate) {
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  IntervalEstimator estimator;
+  estimator.analyze(instructions);
+  chrono::duration<double> analyzeTime = chrono::steady_clock::now() - start;
+
+  cerr << "RAW distance to closest memory / other producer (" << NUMSTAGES 
+       << " for none):" << endl;
+  for (int dMemory = 1; dMemory <= NUMSTAGES; dMemory++) {
+    for (int dOther = 1; dOther <= NUMSTAGES; dOther++) {
+      cerr << "\t" << dMemory << "/" << dOther << ": " << estimator.getCount(dMemory, dOther);
+    }
+    cerr << endl;
+  }
+  cerr << estimator.getNumJumps() << " jumps" << endl;
+
+  for (unsigned int i = 0; i < pipelinePtrs.size(); i++) {
+    start = chrono::steady_clock::now();
+    double estimate = estimator.estimate(pipelinePtrs[i] -> getConfig());
+    chrono::duration<double> estimateTime = chrono::steady_clock::now() - start;
+    // the estimate is a whole number of cycles, printed as such rather than
+    // in scientific notation
+    cout << pipelinePtrs[i] -> getName() << ": Estimated total time is " 
+         << (unsigned long long)estimate << endl;
+    if (validate)
+      validateEstimate(pipelinePtrs[i], instructions, estimate,
+                       analyzeTime.count() + estimateTime.count());
+  }
+}
+
+// This method builds the dependence graph of the instructions; if ilp is
+// true, prints out its critical path, the available ILP (with no window and
+// with a few window sizes), and how many critical path edges involve a load
+// or a multiply; if graphFilename is not empty, writes the graph to that file
+void analyzeDependences(vector<Instruction> &instructions, bool ilp, string graphFilename) {
+  DependenceGraph graph;
+  graph.build(instructions);
+
+  if (graphFilename.length() > 0) {
+    ofstream out(graphFilename.c_str());
+    if (!out) {
+      cerr << "Cannot write dependence graph to " << graphFilename << endl;
+      exit(1);
+    }
+    graph.write(out);
+  }
+  if (!ilp)
+    return;
+
+  int length = graph.getCriticalPathLength();
+  cout << "Critical path is " << length << " instructions long" << endl;
+  cout << "ILP is " << graph.getILP() << " with no window";
+  const unsigned int windows[] = { 4, 16, 64 };
+  for (unsigned int w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+    cout << ", " << graph.getILP(windows[w]) << " with a window of " << windows[w];
+  }
+  cout << endl;
+  if (length > 1) {
+    cout << graph.getNumCriticalLoadOrMultiply() << " of " << length - 1 
+         << " critical path edges involve LB, MULT or MFLO (" 
+         << graph.getNumCriticalLoadOrMultiply() * 100.0 / (length - 1) << "%)" << endl;
+  }
+}
+
+// This method projects the bytes needed to simulate the instructions on all
+// pipelines at once (held), and on one window of windowSize instructions at
+// a time (streamed), besides buffers (the report buffer, and any other);
+// the bytes per instruction of a pipeline are measured on one holding the
+// first few instructions
+void projectMemory(vector<Pipeline*> &pipelinePtrs, vector<Instruction> &instructions,
+                   unsigned int windowSize, size_t buffers, double &held, double &streamed) {
+  unsigned int numProbed = min((unsigned int)instructions.size(), windowSize);
+  vector<Instruction> probed(instructions.begin(), instructions.begin() + numProbed);
+  Pipeline *empty = pipelinePtrs[0] -> createEmpty();
+  Pipeline *probe = pipelinePtrs[0] -> createEmpty();
+  probe -> initialize(probed);
+  double fixed = empty -> getMemoryUsage();
+  double perInstruction = (numProbed == 0) ? 0 : (probe -> getMemoryUsage() - fixed) / numProbed;
+  double instructionBytes = MemoryAccount::objectVectorBytes(instructions);
+  delete empty;
+  delete probe;
+
+  // a window also needs its own copy of the instructions it holds
+  double window = windowSize + NUMSTAGES;
+  held = instructionBytes + buffers + pipelinePtrs.size() * (fixed + perInstruction * instructions.size());
+  streamed = instructionBytes + buffers + fixed + perInstruction * window;
+  if (!instructions.empty())
+    streamed += instructionBytes / instructions.size() * window;
+}
+
+// This method simulates the instructions on pipeline with a
+// StreamingSimulation, only holding a window of instructions at a time,
+// and writes out its totals to report
+void streamInstructions(Pipeline *pipeline, vector<Instruction> &instructions,
+                        StreamingSimulation &streamingSim, ReportWriter &report,
+                        Profiler *profiler) {
+  PROFILE_BEGIN(profiler, "simulation", pipeline -> getName());
+  streamingSim.execute(pipeline, instructions);
+  PROFILE_END(profiler, instructions.size(), streamingSim.getTotalTime());
+  cerr << pipeline -> getName() << ": simulated in " << streamingSim.getNumWindows() 
+       << " windows" << endl;
+
+  PROFILE_BEGIN(profiler, "report", pipeline -> getName());
+  long long stalls[NUMSTALLCAUSES];
+  for (int cause = 0; cause < NUMSTALLCAUSES; cause++) {
+    stalls[cause] = streamingSim.getStalls((StallCause)cause);
+  }
+  report.writeTotals(pipeline -> getName(), instructions.size(), streamingSim.getTotalTime(),
+                     stalls);
+  report.flush();
+  PROFILE_END(profiler, instructions.size(), 0);
+}
+
+// This method reads in edits of the instructions from stdin, one per line:
+//   insert <k> <MIPS assembly instruction>
+//   replace <k> <MIPS assembly instruction>
+//   delete <k>
+//   print
+// After each edit, the execution times in each pipeline are updated by an
+// IncrementalSimulation (only simulating again around the edit), and the
+// total time of each pipeline is printed out; print prints out the
+// execution time of each instruction in each pipeline
+void editInstructions(vector<Pipeline*> &pipelinePtrs, vector<Instruction> &instructions) {
+  vector<IncrementalSimulation*> simulations;
+  for (unsigned int i = 0; i < pipelinePtrs.size(); i++) {
+    simulations.push_back(new IncrementalSimulation(pipelinePtrs[i]));
+    simulations.back() -> load(instructions);
+  }
+
+  ASMParser parser;
+  string line;
+  while (getline(cin, line)) {
+    stringstream ss(line);
+    string command;
+    unsigned int k = 0;
+    ss >> command;
+    if (command.length() == 0)
+      continue;
+
+    if (command == "print") {
+      for (unsigned int i = 0; i < simulations.size(); i++) {
+        const vector<Instruction> &insts = simulations[i] -> getInstructions();
+        const vector<int> &times = simulations[i] -> getExeTimes();
+        cout << pipelinePtrs[i] -> getName() << ": " << endl;
+        cout << "Instr# \t CompletionTime \t Mnemonic " << endl;
+        for (unsigned int j = 0; j < insts.size(); j++) {
+          Instruction inst = insts[j];
+          cout << j << "\t" << times[j] << "\t\t\t" << "|" << inst.getAssembly() << endl;
+        }
+        cout << "Total time is " << simulations[i] -> getTotalTime() << endl;
+      }
+      continue;
+    }
+
+    Instruction inst;
+    string assembly;
+    ss >> k;
+    getline(ss, assembly);
+    if (ss.fail() && command != "delete") {
+      cerr << "Cannot read edit: " << line << endl;
+      continue;
+    }
+    if (command != "delete") {
+      string::size_type start = assembly.find_first_not_of(" \t");
+      if (start == string::npos || !parser.parseLine(assembly.substr(start), inst)) {
+        cerr << "Format of instruction is incorrect: " << assembly << endl;
+        continue;
+      }
+    }
+
+    for (unsigned int i = 0; i < simulations.size(); i++) {
+      bool done = false;
+      if (command == "insert")
+        done = simulations[i] -> insertInstruction(k, inst);
+      else if (command == "replace")
+        done = simulations[i] -> replaceInstruction(k, inst);
+      else if (command == "delete")
+        done = simulations[i] -> deleteInstruction(k);
+      if (!done) {
+        cerr << "Cannot apply edit: " << line << endl;
+        break;
+      }
+      cout << pipelinePtrs[i] -> getName() << ": Total time is " 
+           << simulations[i] -> getTotalTime() << " ("
+           << simulations[i] -> getNumResimulated() << " instructions re-simulated)" << endl;
+    }
+  }
+
+  for (unsigned int i = 0; i < simulations.size(); i++) {
+    delete simulations[i];
+  }
+}
+
 int main(int argc, char *argv[]) {
   if (argc < 2) {
     cerr << "Need to specify a binary encoding / MIPS assembly instruction file"
@@ -79,15 +693,298 @@ int main(int argc, char *argv[]) {
   }
 
   string filename = argv[1];
-  vector<Instruction> instructions;
+  unsigned int numChunks = 1;
+  unsigned int warmup = 2 * NUMSTAGES;
+  bool memoized = false;
+  bool fastForward = false;
+  bool edit = false;
+  unsigned int numSamples = 0;
+  unsigned int sampleSize = 1000;
+  bool randomSamples = false;
+  unsigned int seed = 1;
+  bool estimate = false;
+  bool validate = false;
+  bool ilp = false;
+  bool stalls = false;
+  int diagramFirst = -1;
+  int diagramLast = -1;
+  string traceFilename;
+  ReportFormat format = REPORT_TEXT;
+  string graphFilename;
+  string resultsFilename;
+  string profileFilename;
+  bool counters = false;
+  bool memory = false;
+  size_t memoryBudget = 0;
+  unsigned int width = 0;
+  unsigned int numUnits[NUMUNITS] = { 1, 1 };
+  string stageCycles;
+  string latencies;
+  string pipelinedUnits;
+  bool ooo = false;
+  unsigned int robSize = 32;
+  unsigned int numStations = 16;
+  string l1Config;
+  string l1iConfig;
+  string l2Config;
+  unsigned int fetchQueueSize = 0;
+  string predictorSpec;
+  string btbEntries;
+  unsigned int memoryLatency = 100;
+  int forwardPaths = FORWARD_BY_STAGES;
+  bool forwardReport = false;
+  string coreFilenames;
+  unsigned int busWidth = 1;
+  BusArbitration arbitration = ARBITRATE_ROUND_ROBIN;
+  bool fetchOnBus = false;
 
-  if (filename.compare(filename.size() - 3, 3, "asm") == 0) {
-    // if input file contains MIPS assembly instructions
-    instructions = getInstFromASMFile(filename);
-  } else {
-    // if input file contains binary encodings
-    instructions = getInstFromBinaryFile(filename);
+  // read in the options following the filename
+  for (int arg = 2; arg < argc; arg++) {
+    string option = argv[arg];
+    if (option == "-chunks" && arg + 1 < argc) {
+      numChunks = atoi(argv[++arg]);
+    } else if (option == "-warmup" && arg + 1 < argc) {
+      warmup = atoi(argv[++arg]);
+    } else if (option == "-memo") {
+      memoized = true;
+    } else if (option == "-fastforward") {
+      memoized = true;
+      fastForward = true;
+    } else if (option == "-edit") {
+      edit = true;
+    } else if (option == "-sample" && arg + 1 < argc) {
+      numSamples = atoi(argv[++arg]);
+    } else if (option == "-samplesize" && arg + 1 < argc) {
+      sampleSize = atoi(argv[++arg]);
+    } else if (option == "-seed" && arg + 1 < argc) {
+      randomSamples = true;
+      seed = atoi(argv[++arg]);
+    } else if (option == "-estimate") {
+      estimate = true;
+    } else if (option == "-validate") {
+      validate = true;
+    } else if (option == "-diagram" && arg + 2 < argc) {
+      diagramFirst = atoi(argv[++arg]);
+      diagramLast = atoi(argv[++arg]);
+    } else if (option == "-format" && arg + 1 < argc) {
+      bool ok;
+      format = ReportWriter::getFormat(argv[++arg], ok);
+      if (!ok) {
+        cerr << "Unknown format " << argv[arg] << endl;
+        exit(1);
+      }
+    } else if (option == "-trace" && arg + 1 < argc) {
+      traceFilename = argv[++arg];
+    } else if (option == "-results" && arg + 1 < argc) {
+      resultsFilename = argv[++arg];
+    } else if (option == "-profile" && arg + 1 < argc) {
+      profileFilename = argv[++arg];
+    } else if (option == "-counters") {
+      counters = true;
+    } else if (option == "-width" && arg + 1 < argc) {
+      width = atoi(argv[++arg]);
+      if (width == 0) {
+        cerr << "-width needs at least 1 instruction per cycle." << endl;
+        exit(1);
+      }
+    } else if (option == "-memports" && arg + 1 < argc) {
+      numUnits[UNIT_MEMORY] = atoi(argv[++arg]);
+    } else if (option == "-multipliers" && arg + 1 < argc) {
+      numUnits[UNIT_MULTIPLIER] = atoi(argv[++arg]);
+    } else if (option == "-stages" && arg + 1 < argc) {
+      stageCycles = argv[++arg];
+    } else if (option == "-latency" && arg + 1 < argc) {
+      latencies = argv[++arg];
+    } else if (option == "-pipelined" && arg + 1 < argc) {
+      pipelinedUnits = argv[++arg];
+    } else if (option == "-ooo") {
+      ooo = true;
+    } else if (option == "-rob" && arg + 1 < argc) {
+      robSize = atoi(argv[++arg]);
+      if (robSize == 0) {
+        cerr << "-rob needs at least 1 entry." << endl;
+        exit(1);
+      }
+    } else if (option == "-rs" && arg + 1 < argc) {
+      numStations = atoi(argv[++arg]);
+      if (numStations == 0 || numStations > OutOfOrderPipeline::MAXSTATIONS) {
+        cerr << "-rs needs from 1 to " << OutOfOrderPipeline::MAXSTATIONS 
+             << " reservation stations." << endl;
+        exit(1);
+      }
+    } else if (option == "-l1d" && arg + 1 < argc) {
+      l1Config = argv[++arg];
+    } else if (option == "-l1i" && arg + 1 < argc) {
+      l1iConfig = argv[++arg];
+    } else if (option == "-fetchqueue" && arg + 1 < argc) {
+      fetchQueueSize = atoi(argv[++arg]);
+    } else if (option == "-predictor" && arg + 1 < argc) {
+      predictorSpec = argv[++arg];
+    } else if (option == "-btb" && arg + 1 < argc) {
+      btbEntries = argv[++arg];
+    } else if (option == "-forward" && arg + 1 < argc) {
+      if (!ForwardingPipeline::parsePaths(argv[++arg], forwardPaths)) {
+        cerr << "Cannot read forwarding paths " << argv[arg] << endl;
+        exit(1);
+      }
+    } else if (option == "-forwardreport") {
+      forwardReport = true;
+    } else if (option == "-multicore" && arg + 1 < argc) {
+      coreFilenames = argv[++arg];
+    } else if (option == "-bus" && arg + 1 < argc) {
+      busWidth = atoi(argv[++arg]);
+      if (busWidth == 0) {
+        cerr << "-bus needs at least 1 transfer per cycle." << endl;
+        exit(1);
+      }
+    } else if (option == "-arbitration" && arg + 1 < argc) {
+      string name = argv[++arg];
+      if (name == "roundrobin") {
+        arbitration = ARBITRATE_ROUND_ROBIN;
+      } else if (name == "fixed") {
+        arbitration = ARBITRATE_FIXED;
+      } else {
+        cerr << "Unknown arbitration " << name << endl;
+        exit(1);
+      }
+    } else if (option == "-busfetch") {
+      fetchOnBus = true;
+    } else if (option == "-l2" && arg + 1 < argc) {
+      l2Config = argv[++arg];
+    } else if (option == "-memlatency" && arg + 1 < argc) {
+      memoryLatency = atoi(argv[++arg]);
+    } else if (option == "-memory") {
+      memory = true;
+    } else if (option == "-memorybudget" && arg + 1 < argc) {
+      if (!MemoryAccount::parseSize(argv[++arg], memoryBudget) || memoryBudget == 0) {
+        cerr << "Cannot read memory budget " << argv[arg] << endl;
+        exit(1);
+      }
+    } else if (option == "-stalls") {
+      stalls = true;
+    } else if (option == "-ilp") {
+      ilp = true;
+    } else if (option == "-graph" && arg + 1 < argc) {
+      graphFilename = argv[++arg];
+    } else {
+      cerr << "Unknown option " << option << endl;
+      exit(1);
+    }
+  }
+  if (memoized && numChunks > 1) {
+    cerr << "-memo / -fastforward and -chunks cannot be used together." << endl;
+    exit(1);
+  }
+  if ((numSamples > 0 || estimate) && (memoized || numChunks > 1 || edit)) {
+    cerr << "-sample / -estimate cannot be used with -memo / -fastforward, -chunks or -edit." << endl;
+    exit(1);
+  }
+  bool diagram = diagramFirst >= 0;
+  bool timeline = diagram || traceFilename.length() > 0;
+  if ((stalls || timeline) && (memoized || numChunks > 1)) {
+    // the stalls and timelines are only recorded by the pipeline simulating every cycle
+    cerr << "-stalls / -diagram / -trace cannot be used with -memo / -fastforward or -chunks." 
+         << endl;
+    exit(1);
+  }
+  if (diagram && diagramLast < diagramFirst) {
+    cerr << "-diagram needs a first instruction not after the last one." << endl;
+    exit(1);
+  }
+  if (numSamples > 0 && estimate) {
+    cerr << "-sample and -estimate cannot be used together." << endl;
+    exit(1);
+  }
+  CacheConfig l1CacheConfig, l1iCacheConfig, l2CacheConfig;
+  if (l1Config.length() > 0 && !DataCache::parseConfig(l1Config, l1CacheConfig)) {
+    cerr << "Cannot read L1 data cache " << l1Config << endl;
+    exit(1);
+  }
+  if (l1iConfig.length() > 0 && !DataCache::parseConfig(l1iConfig, l1iCacheConfig)) {
+    cerr << "Cannot read I-cache " << l1iConfig << endl;
+    exit(1);
+  }
+  bool caches = l1Config.length() > 0 || l1iConfig.length() > 0;
+  if (l2Config.length() > 0 && (!caches || !DataCache::parseConfig(l2Config, l2CacheConfig))) {
+    cerr << "Cannot read L2 cache " << l2Config << " (it needs -l1d or -l1i)" << endl;
+    exit(1);
+  }
+  bool frontEnd = l1iConfig.length() > 0 || fetchQueueSize > 0;
+  BranchPredictor *predictor = NULL;
+  if (predictorSpec.length() > 0) {
+    predictor = BranchPredictor::create(predictorSpec);
+    if (predictor == NULL) {
+      cerr << "Cannot read branch predictor " << predictorSpec << endl;
+      exit(1);
+    }
+  }
+  BranchPredictor *btb = NULL;
+  if (btbEntries.length() > 0) {
+    btb = BranchPredictor::create("btb:" + btbEntries);
+    if (btb == NULL) {
+      cerr << "-btb needs a power of two entries." << endl;
+      exit(1);
+    }
+  }
+  bool prediction = predictor != NULL || btb != NULL;
+  // the stages and latencies, the caches, the front end and the branch
+  // predictions are only modeled by a SuperscalarPipeline, of width 1
+  // unless given
+  bool superscalar = width > 0 || stageCycles.length() > 0 || latencies.length() > 0 
+                     || pipelinedUnits.length() > 0 || caches || frontEnd || prediction;
+  // so are the forwarding paths, in a pipeline of their own
+  if (forwardReport && forwardPaths == FORWARD_BY_STAGES)
+    forwardPaths = ALLFORWARDPATHS;
+  bool paths = forwardPaths != FORWARD_BY_STAGES;
+  if ((superscalar || paths) && (memoized || numChunks > 1 || numSamples > 0 || estimate || edit)) {
+    // they all resume the pipeline from states holding one inst per stage
+    cerr << "-width / -stages / -latency / -pipelined / -l1d / -l1i / -fetchqueue / -predictor "
+         << "/ -btb / -forward cannot be used with -memo / -fastforward, -chunks, -sample, "
+         << "-estimate or -edit." << endl;
+    exit(1);
+  }
+  if (ooo && (memoized || numChunks > 1 || numSamples > 0 || estimate || edit)) {
+    // as for -width, there is no single state to resume the pipeline from
+    cerr << "-ooo cannot be used with -memo / -fastforward, -chunks, -sample, -estimate or -edit."
+         << endl;
+    exit(1);
+  }
+  bool multiCore = coreFilenames.length() > 0;
+  if (multiCore && (memoized || numChunks > 1 || numSamples > 0 || estimate || edit || superscalar
+                    || paths || ooo || stalls || timeline || resultsFilename.length() > 0
+                    || memoryBudget > 0)) {
+    // each core is a plain pipeline, whose totals are all that is printed
+    cerr << "-multicore cannot be used with -memo / -fastforward, -chunks, -sample, -estimate, "
+         << "-edit, -width (-stages, -l1d, ...), -forward, -ooo, -stalls, -diagram, -trace, "
+         << "-results or -memorybudget." << endl;
+    exit(1);
+  }
+  if (counters && profileFilename.length() == 0) {
+    cerr << "-counters needs -profile." << endl;
+    exit(1);
   }
+#ifndef PROFILE
+  if (profileFilename.length() > 0) {
+    cerr << "-profile needs PIPESIM built with make PROFILE=1." << endl;
+    exit(1);
+  }
+#endif
+  Profiler *profiler = NULL;
+  if (profileFilename.length() > 0) {
+    profiler = new Profiler();
+    if (counters && !profiler -> enableCounters())
+      cerr << "Cannot count perf events (" << profiler -> getCountersError()
+           << "), only timing the phases." << endl;
+  }
+  MemoryAccount memoryAccount;
+  MemoryAccount *account = memory ? &memoryAccount : NULL;
+  vector<Instruction> instructions;
+
+  PROFILE_BEGIN(profiler, "parse", "");
+  instructions = getInstFromFile(filename, account);
+  PROFILE_END(profiler, instructions.size(), 0);
+  if (account != NULL)
+    account -> add("instructions", MemoryAccount::objectVectorBytes(instructions));
 
   // this vector will store 3 pointers, each of which points to 
   // a instance of Pipeline class; more specifically, one of them 
@@ -107,16 +1004,327 @@ int main(int argc, char *argv[]) {
   pipelinePtrs.push_back(stallPL);
   pipelinePtrs.push_back(forwardingPL);
 
+  // or the cores running the file and each trace listed, if asked
+  if (multiCore) {
+    vector<string> filenames(1, filename);
+    stringstream ss(coreFilenames);
+    string coreFilename;
+    while (getline(ss, coreFilename, ',')) {
+      filenames.push_back(coreFilename);
+    }
+    vector<vector<Instruction> > traces(1, instructions);
+    PROFILE_BEGIN(profiler, "parse", "cores");
+    long long numParsed = 0;
+    for (unsigned int c = 1; c < filenames.size(); c++) {
+      traces.push_back(getInstFromFile(filenames[c], NULL));
+      numParsed += traces.back().size();
+    }
+    PROFILE_END(profiler, numParsed, 0);
+    MultiCoreSimulation multiCoreSim(busWidth, arbitration, fetchOnBus);
+    simulateCores(pipelinePtrs, traces, filenames, multiCoreSim, profiler);
+    if (account != NULL) {
+      size_t traceBytes = MemoryAccount::vectorBytes(traces);
+      for (unsigned int c = 0; c < traces.size(); c++) {
+        traceBytes += MemoryAccount::objectVectorBytes(traces[c]);
+      }
+      account -> add("core instructions", traceBytes);
+      account -> add("multi-core simulation", multiCoreSim.getMemoryUsage());
+      account -> write(cerr, instructions.size());
+    }
+    writeProfile(profiler, profileFilename);
+    for (unsigned int i = 0; i < pipelinePtrs.size(); i++) {
+      delete pipelinePtrs[i];
+    }
+    return(0);
+  }
+
+  // the cycles each load takes to be served by the data caches, and each
+  // fetch is held up by the I-cache, if any
+  vector<unsigned int> memoryCycles;
+  vector<unsigned int> fetchCycles;
+  if (caches) {
+    DataCache *l2 = NULL;
+    if (l2Config.length() > 0)
+      l2 = new DataCache(l2CacheConfig, NULL, memoryLatency);
+    DataCache *l1d = NULL;
+    if (l1Config.length() > 0)
+      l1d = new DataCache(l1CacheConfig, l2, memoryLatency);
+    DataCache *l1i = NULL;
+    if (l1iConfig.length() > 0)
+      l1i = new DataCache(l1iCacheConfig, l2, memoryLatency);
+    runCaches(instructions, l1d, l1i, memoryCycles, fetchCycles);
+    size_t cacheBytes = 0;
+    DataCache *levels[3] = { l1i, l1d, l2 };
+    const char *names[3] = { "L1I", "L1D", "L2" };
+    for (int level = 0; level < 3; level++) {
+      if (levels[level] == NULL)
+        continue;
+      levels[level] -> write(cerr, names[level], instructions.size());
+      cacheBytes += levels[level] -> getMemoryUsage();
+      delete levels[level];
+    }
+    if (account != NULL)
+      account -> add("caches", cacheBytes);
+  }
+
+  // the jumps and branches predicted right at fetch, if any predictor
+  vector<bool> predicted;
+  if (prediction) {
+    predicted = runPredictor(instructions, predictor, btb);
+    if (account != NULL)
+      account -> add("branch predictors", (predictor != NULL ? predictor -> getMemoryUsage() : 0)
+                                          + (btb != NULL ? btb -> getMemoryUsage() : 0));
+    delete predictor;
+    delete btb;
+  }
+
+  // each of them issuing up to width insts per cycle, or with the stages
+  // and latencies given, instead, if asked, and one forwarding the results
+  // along the paths given after them
+  SuperscalarPipeline *pathsPL = NULL;
+  if (superscalar || paths) {
+    unsigned int numInOrder = pipelinePtrs.size();
+    for (unsigned int i = 0; i < numInOrder + (paths ? 1 : 0); i++) {
+      if (i < numInOrder && !superscalar)
+        continue;
+      string name = (i < numInOrder) ? pipelinePtrs[i] -> getName()
+                                     : "FORWARD:" + ForwardingPipeline::getPathsName(forwardPaths);
+      if (width > 0)
+        name += "-W" + to_string(width);
+      PipelineConfig config = (i < numInOrder) ? pipelinePtrs[i] -> getConfig()
+                                               : ForwardingPipeline::getPathsConfig(forwardPaths);
+      SuperscalarPipeline *superscalarPL = new SuperscalarPipeline(config, name, max(width, 1u));
+      for (int unit = 0; unit < NUMUNITS; unit++) {
+        superscalarPL -> setNumUnits((FunctionalUnit)unit, numUnits[unit]);
+      }
+      if (!superscalarPL -> setStageCycles(stageCycles)) {
+        cerr << "Cannot read stage cycles " << stageCycles << endl;
+        exit(1);
+      }
+      if (!superscalarPL -> setLatencies(latencies)) {
+        cerr << "Cannot read latencies " << latencies << endl;
+        exit(1);
+      }
+      if (!superscalarPL -> setPipelinedUnits(pipelinedUnits)) {
+        cerr << "Cannot read pipelined units " << pipelinedUnits << endl;
+        exit(1);
+      }
+      superscalarPL -> setMemoryCycles(memoryCycles);
+      superscalarPL -> setFetchMissCycles(fetchCycles);
+      superscalarPL -> setFetchQueueSize(fetchQueueSize);
+      superscalarPL -> setPredicted(predicted);
+      if (i < numInOrder) {
+        delete pipelinePtrs[i];
+        pipelinePtrs[i] = superscalarPL;
+      } else {
+        pathsPL = superscalarPL;
+        pipelinePtrs.push_back(pathsPL);
+      }
+    }
+  }
+
+  // and an out-of-order one after them, if asked
+  OutOfOrderPipeline *oooPL = NULL;
+  if (ooo) {
+    oooPL = new OutOfOrderPipeline(width > 0 ? "OOO-W" + to_string(width) : "OOO",
+                                   max(width, 1u), robSize, numStations);
+    oooPL -> setPredicted(predicted);
+    pipelinePtrs.push_back(oooPL);
+  }
+
+  if (numSamples > 0 || estimate) {
+    if (estimate) {
+      estimateInstructions(pipelinePtrs, instructions, validate);
+    } else {
+      SampledSimulation sampledSim(numSamples, sampleSize, warmup, randomSamples, seed);
+      sampleInstructions(pipelinePtrs, instructions, sampledSim, validate);
+    }
+    for (unsigned int i = 0; i < pipelinePtrs.size(); i++) {
+      delete pipelinePtrs[i];
+    }
+    return(0);
+  }
+
+  // past the budget, each pipeline only holds a window of instructions at a
+  // time, which leaves nothing but the totals to print out
+  unsigned int windowSize = 4096;
+  StreamingSimulation streamingSim(windowSize);
+  bool streaming = false;
+  size_t windowBytes = 0;     // held by the largest window, one at a time
+  if (memoryBudget > 0) {
+    size_t buffers = ReportWriter(cout, format).getMemoryUsage();
+    double held, streamed;
+    projectMemory(pipelinePtrs, instructions, windowSize, buffers, held, streamed);
+    if (held > memoryBudget) {
+      cerr << "Projected memory of " << (long long)held << " bytes is over the budget of "
+           << memoryBudget << " bytes: ";
+      if (stalls || timeline || resultsFilename.length() > 0 || edit || superscalar || paths
+          || ooo) {
+        cerr << "simulating in full anyway, since -stalls, -diagram, -trace, -results, "
+             << "-edit, -width (-stages, -l1d, ...), -forward and -ooo need every pipeline "
+             << "simulated at once" << endl;
+      } else {
+        streaming = true;
+        format = REPORT_SUMMARY;
+        cerr << "simulating in windows of " << windowSize << " instructions, "
+             << "and only printing out the totals (projected " << (long long)streamed 
+             << " bytes" << (streamed > memoryBudget ? ", still over budget" : "") << ")" << endl;
+      }
+    }
+  }
+
+  // the timeline of every instruction is exported, unless a range is given
+  TraceWriter *traceWriter = NULL;
+  if (traceFilename.length() > 0) {
+    traceWriter = new TraceWriter(traceFilename);
+    if (!traceWriter -> isOpen()) {
+      cerr << "Cannot write trace to " << traceFilename << endl;
+      exit(1);
+    }
+    if (!diagram) {
+      diagramFirst = 0;
+      diagramLast = (int)instructions.size() - 1;
+    }
+  }
+
   // iterates through the vector of pointers, and simulates running the
   // instructions in each pipelines, and print out the output
+  ReportWriter report(cout, format);
   for (unsigned int i = 0; i < pipelinePtrs.size(); i++) {
+    if (streaming) {
+      streamInstructions(pipelinePtrs[i], instructions, streamingSim, report, profiler);
+      windowBytes = max(windowBytes, streamingSim.getPeakMemoryUsage());
+      continue;
+    }
+    PROFILE_BEGIN(profiler, "dependences", pipelinePtrs[i] -> getName());
     pipelinePtrs[i] -> initialize(instructions);
-    pipelinePtrs[i] -> execute();
-    pipelinePtrs[i] -> print();  
+    PROFILE_END(profiler, instructions.size(), 0);
+    if (timeline)
+      pipelinePtrs[i] -> recordTimeline(diagramFirst, diagramLast);
+    PROFILE_BEGIN(profiler, "simulation", pipelinePtrs[i] -> getName());
+    if (memoized) {
+      MemoizedSimulation memoSim(fastForward);
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      memoSim.execute(pipelinePtrs[i], instructions);
+      chrono::duration<double> memoTime = chrono::steady_clock::now() - start;
+      if (memoSim.isMemoized()) {
+        cerr << pipelinePtrs[i] -> getName() << ": memo hit rate "
+             << memoSim.getHitRate() * 100 << "% (" << memoSim.getNumHits() << " hits, "
+             << memoSim.getNumMisses() << " misses)";
+      } else {
+        cerr << pipelinePtrs[i] -> getName() << ": every cycle simulated (memoizing only "
+             << "pays off for a pipeline that stalls, with at least "
+             << MemoizedSimulation::MINMEMOIZED << " instructions)";
+      }
+      if (fastForward && memoSim.isMemoized()) {
+        cerr << ", " << memoSim.getNumFastForwarded() << " of " << instructions.size()
+             << " instructions fast-forwarded in " << memoSim.getNumLoops() << " loops";
+        // the speedup is measured against simulating every cycle with
+        // execute(), on a pipeline of the same kind
+        Pipeline *plainPL = pipelinePtrs[i] -> createEmpty();
+        plainPL -> initialize(instructions);
+        start = chrono::steady_clock::now();
+        plainPL -> execute();
+        chrono::duration<double> plainTime = chrono::steady_clock::now() - start;
+        delete plainPL;
+        cerr << ", simulated in " << memoTime.count() << "s instead of "
+             << plainTime.count() << "s";
+        if (memoTime.count() > 0)
+          cerr << " (" << plainTime.count() / memoTime.count() << "x speedup)";
+      }
+      cerr << endl;
+    } else if (numChunks > 1) {
+      ChunkedSimulation chunkedSim(numChunks, warmup);
+      chunkedSim.execute(pipelinePtrs[i], instructions);
+      cerr << pipelinePtrs[i] -> getName() << ": " << chunkedSim.getNumChunks()
+           << " chunks, " << chunkedSim.getNumResimulated() << " re-simulated" << endl;
+    } else {
+      pipelinePtrs[i] -> execute();
+    }
+    if (forwardReport && pipelinePtrs[i] == pathsPL)
+      reportForwardPaths(pathsPL, instructions);
+    if (frontEnd && pipelinePtrs[i] != oooPL) {
+      SuperscalarPipeline *superscalarPL = (SuperscalarPipeline *)pipelinePtrs[i];
+      cerr << superscalarPL -> getName() << ": front-end bound "
+           << superscalarPL -> getNumFrontEndBoundCycles() << " cycles, back-end bound "
+           << superscalarPL -> getNumBackEndBoundCycles() << " cycles" << endl;
+    }
+    if (prediction)
+      reportMispredictions(pipelinePtrs[i], predicted);
+    if (pipelinePtrs[i] == oooPL) {
+      cerr << oooPL -> getName() << ": IPC " << oooPL -> getIPC() << ", ROB full "
+           << oooPL -> getNumROBFullCycles() << " cycles, reservation stations full "
+           << oooPL -> getNumStationsFullCycles() << " cycles, operands awaited "
+           << oooPL -> getNumOperandWaitCycles() << " cycles, issue slots awaited "
+           << oooPL -> getNumIssueWaitCycles() << " cycles" << endl;
+    }
+    // the cycles simulated are the completion time of the last instruction
+    PROFILE_END(profiler, instructions.size(), instructions.empty() ? 0 :
+                pipelinePtrs[i] -> getExeTimes().back());
+    // only a pipeline simulating every cycle records its stalls, and the
+    // out-of-order one only those of its front end, so its lost cycles are
+    // not broken down by cause (its metrics above tell them apart)
+    PROFILE_BEGIN(profiler, "report", pipelinePtrs[i] -> getName());
+    report.writePipeline(pipelinePtrs[i], !memoized && numChunks <= 1 && pipelinePtrs[i] != oooPL);
+    report.flush();
+    PROFILE_END(profiler, instructions.size(), 0);
+    if (stalls) {
+      cout << "\n";
+      pipelinePtrs[i] -> printStalls(10);
+    }
+    if (diagram) {
+      cout << "\n";
+      pipelinePtrs[i] -> printDiagram();
+    }
+    if (traceWriter != NULL)
+      pipelinePtrs[i] -> writeTrace(*traceWriter, i);
     if (i != pipelinePtrs.size() - 1) 
-      cout << endl;
+      report.writeSeparator();
+  }
+  report.flush();
+
+  if (account != NULL) {
+    for (unsigned int i = 0; i < pipelinePtrs.size() && !streaming; i++) {
+      size_t dependences = pipelinePtrs[i] -> getDependencyChecker() -> getMemoryUsage();
+      account -> add(pipelinePtrs[i] -> getName() + " pipeline",
+                     pipelinePtrs[i] -> getMemoryUsage() - dependences);
+      account -> add(pipelinePtrs[i] -> getName() + " dependences", dependences);
+    }
+    if (streaming)
+      account -> add("pipeline window", windowBytes);
+    account -> add("report buffer", report.getMemoryUsage());
+    if (traceWriter != NULL)
+      account -> add("trace buffer", traceWriter -> getMemoryUsage());
   }
 
+  if (traceWriter != NULL)
+    delete traceWriter;
+
+  if (resultsFilename.length() > 0) {
+    PROFILE_BEGIN(profiler, "results", "");
+    ResultsFile results(resultsFilename);
+    if (!results.write(instructions, pipelinePtrs, !memoized && numChunks <= 1)) {
+      cerr << "Cannot write results to " << resultsFilename << endl;
+      exit(1);
+    }
+    PROFILE_END(profiler, instructions.size(), 0);
+    if (account != NULL)
+      account -> add("results buffer", results.getMemoryUsage());
+  }
+
+  if (account != NULL)
+    account -> write(cerr, instructions.size());
+
+  writeProfile(profiler, profileFilename);
+
+  if (ilp || graphFilename.length() > 0) {
+    cout << endl;
+    analyzeDependences(instructions, ilp, graphFilename);
+  }
+
+  if (edit)
+    editInstructions(pipelinePtrs, instructions);
+
   // delete the pointers
   for (unsigned int i = 0; i < pipelinePtrs.size(); i++) {
     delete pipelinePtrs[i];
@@ -0,0 +1,137 @@
+// Name: Maxine Xin
+#include "Profiler.h"
+
+#include <sys/resource.h>
+
+Profiler::Profiler() {
+  myStart = chrono::steady_clock::now();
+  myPhaseStart = myStart;
+  myCountersEnabled = false;
+}
+
+/* also counts hardware events in each phase; returns false (and only
+ * times the phases) if perf events cannot be counted, with the reason
+ * in getCountersError()
+ */
+bool Profiler::enableCounters() {
+  myCountersEnabled = myCounters.isOpen() || myCounters.open();
+  return myCountersEnabled;
+}
+
+/* starts timing phase, of pipeline model (empty if none)
+ */
+void Profiler::begin(const string &phase, const string &model) {
+  Phase p;
+  p.name = phase;
+  p.model = model;
+  p.seconds = 0;
+  p.instructions = 0;
+  p.cycles = 0;
+  for (int e = 0; e < NUMPERFEVENTS; e++) {
+    p.counts[e] = -1;
+  }
+  myPhases.push_back(p);
+  myPhaseStart = chrono::steady_clock::now();
+  if (myCountersEnabled)
+    myCounters.start();
+}
+
+/* stops timing the phase begun last, which went through instructions
+ * instructions and simulated cycles cycles
+ */
+void Profiler::end(long long instructions, long long cycles) {
+  long long counts[NUMPERFEVENTS];
+  if (myCountersEnabled)
+    myCounters.stop(counts);
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - myPhaseStart;
+  if (myPhases.empty())
+    return;
+  myPhases.back().seconds = elapsed.count();
+  myPhases.back().instructions = instructions;
+  myPhases.back().cycles = cycles;
+  if (myCountersEnabled) {
+    for (int e = 0; e < NUMPERFEVENTS; e++) {
+      myPhases.back().counts[e] = counts[e];
+    }
+  }
+}
+
+/* writes the time and throughput of each phase, as a table / as a
+ * JSON object on one line
+ */
+void Profiler::writeText(ostream &out) {
+  chrono::duration<double> total = chrono::steady_clock::now() - myStart;
+  out << "Phase \t\t Model \t\t Seconds \t Instructions/s \t Cycles/s";
+  if (myCountersEnabled)
+    out << " \t Host cycles \t Host IPC \t LLC misses \t Branch misses";
+  out << endl;
+  for (unsigned int i = 0; i < myPhases.size(); i++) {
+    const Phase &p = myPhases[i];
+    out << p.name << "\t\t" << (p.model.empty() ? "-" : p.model) << "\t\t" << p.seconds << "\t\t";
+    if (p.seconds > 0)
+      out << p.instructions / p.seconds << "\t\t";
+    else
+      out << "-\t\t";
+    if (p.cycles > 0 && p.seconds > 0)
+      out << p.cycles / p.seconds;
+    else
+      out << "-";
+    if (myCountersEnabled) {
+      out << "\t\t";
+      if (p.counts[PERF_CYCLES] >= 0)
+        out << p.counts[PERF_CYCLES];
+      else
+        out << "-";
+      out << "\t\t";
+      if (p.counts[PERF_CYCLES] > 0 && p.counts[PERF_INSTRUCTIONS] >= 0)
+        out << (double)p.counts[PERF_INSTRUCTIONS] / p.counts[PERF_CYCLES];
+      else
+        out << "-";
+      for (int e = PERF_LLC_MISSES; e <= PERF_BRANCH_MISSES; e++) {
+        out << "\t\t";
+        if (p.counts[e] >= 0)
+          out << p.counts[e];
+        else
+          out << "-";
+      }
+    }
+    out << endl;
+  }
+  out << "Total " << total.count() << " s, peak RSS " << getPeakRSS() << " KB" << endl;
+}
+
+void Profiler::writeJSON(ostream &out) {
+  chrono::duration<double> total = chrono::steady_clock::now() - myStart;
+  out << "{\"phases\":[";
+  for (unsigned int i = 0; i < myPhases.size(); i++) {
+    const Phase &p = myPhases[i];
+    if (i > 0)
+      out << ",";
+    out << "{\"phase\":\"" << p.name << "\",\"model\":\"" << p.model
+        << "\",\"seconds\":" << p.seconds << ",\"instructions\":" << p.instructions
+        << ",\"cycles\":" << p.cycles << ",\"instructions_per_second\":"
+        << (p.seconds > 0 ? p.instructions / p.seconds : 0) << ",\"cycles_per_second\":"
+        << (p.seconds > 0 ? p.cycles / p.seconds : 0);
+    // the events the simulator caused on the host, when counted
+    for (int e = 0; e < NUMPERFEVENTS; e++) {
+      if (p.counts[e] >= 0)
+        out << ",\"host_" << PerfCounters::getName(e) << "\":" << p.counts[e];
+    }
+    if (p.counts[PERF_CYCLES] > 0 && p.counts[PERF_INSTRUCTIONS] >= 0)
+      out << ",\"host_ipc\":" << (double)p.counts[PERF_INSTRUCTIONS] / p.counts[PERF_CYCLES];
+    out << "}";
+  }
+  out << "],\"total_seconds\":" << total.count() << ",\"peak_rss_kb\":" << getPeakRSS()
+      << ",\"counters\":" << (myCountersEnabled ? "true" : "false") << "}" << endl;
+}
+
+/* returns the peak resident set size of the process in kilobytes, or
+ * -1 if not known
+ */
+long Profiler::getPeakRSS() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return -1;
+  // in kilobytes on Linux
+  return usage.ru_maxrss;
+}
@@ -0,0 +1,83 @@
+// Name: Maxine Xin
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "PerfCounters.h"
+
+using namespace std;
+
+/* The phases of the simulator are only timed when it is built with
+ * -DPROFILE (make PROFILE=1); otherwise these compile to nothing.
+ * profiler may be NULL, when profiling was not asked for at run time.
+ */
+#ifdef PROFILE
+#define PROFILE_BEGIN(profiler, phase, model) \
+  do { if ((profiler) != NULL) (profiler) -> begin(phase, model); } while (0)
+#define PROFILE_END(profiler, instructions, cycles) \
+  do { if ((profiler) != NULL) (profiler) -> end(instructions, cycles); } while (0)
+#else
+#define PROFILE_BEGIN(profiler, phase, model) do { } while (0)
+#define PROFILE_END(profiler, instructions, cycles) do { } while (0)
+#endif
+
+/* This class times the phases of a run of the simulator (parsing, dependence
+ * analysis, simulation and report of each pipeline) with a monotonic clock,
+ * and reports for each phase the instructions and simulated cycles per
+ * second, along with the peak resident set size of the process. With the
+ * hardware counters enabled, it also reports the cycles, instructions, IPC,
+ * last level cache misses and branch misses of the simulator in each phase.
+ */
+class Profiler {
+  public:
+    Profiler();
+
+    /* also counts hardware events in each phase; returns false (and only
+     * times the phases) if perf events cannot be counted, with the reason
+     * in getCountersError()
+     */
+    bool enableCounters();
+    string getCountersError() { return myCounters.getError(); };
+
+    /* starts timing phase, of pipeline model (empty if none)
+     */
+    void begin(const string &phase, const string &model);
+
+    /* stops timing the phase begun last, which went through instructions
+     * instructions and simulated cycles cycles
+     */
+    void end(long long instructions, long long cycles);
+
+    /* writes the time and throughput of each phase, as a table / as a
+     * JSON object on one line
+     */
+    void writeText(ostream &out);
+    void writeJSON(ostream &out);
+
+    /* returns the peak resident set size of the process in kilobytes, or
+     * -1 if not known
+     */
+    static long getPeakRSS();
+
+  private:
+    struct Phase {
+      string name;
+      string model;
+      double seconds;
+      long long instructions;
+      long long cycles;
+      long long counts[NUMPERFEVENTS];   // of the simulator itself, -1 if not counted
+    };
+
+    chrono::steady_clock::time_point myStart;       // of the profiler
+    chrono::steady_clock::time_point myPhaseStart;  // of the phase begun last
+    vector<Phase> myPhases;
+    PerfCounters myCounters;
+    bool myCountersEnabled;
+};
+
+#endif
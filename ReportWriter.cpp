@@ -0,0 +1,321 @@
+// Name: Maxine Xin
+#include "ReportWriter.h"
+
+#include <algorithm>
+#include <cstdio>
+
+/* writes to out, in format
+ */
+ReportWriter::ReportWriter(ostream &out, ReportFormat format) : myOut(out) {
+  myFormat = format;
+  myBuffer.reserve(BUFFER_SIZE + 256);
+  myHeaderWritten = false;
+}
+
+/* writes out what is left in the buffer
+ */
+ReportWriter::~ReportWriter() {
+  flush();
+}
+
+/* writes the report of pipeline, which has run; stallsRecorded tells
+ * whether the pipeline recorded its stalls (i.e. simulated every cycle),
+ * otherwise only the total stall cycles are known
+ */
+void ReportWriter::writePipeline(Pipeline *pipeline, bool stallsRecorded) {
+  string name = pipeline -> getName();
+  const list<Instruction> &instructions = pipeline -> getInstructions();
+
+  // look the instructions up by number instead of going through the list
+  vector<const Instruction*> insts;
+  insts.reserve(instructions.size());
+  list<Instruction>::const_iterator it;
+  for (it = instructions.begin(); it != instructions.end(); it++) {
+    insts.push_back(&(*it));
+  }
+  const vector<int> &exeTimes = pipeline -> getExeTimes();
+  long long numInstructions = insts.size();
+  long long totalTime = exeTimes.empty() ? 0 : exeTimes.back();
+
+  if (myFormat == REPORT_TEXT) {
+    myBuffer += name;
+    myBuffer += ": \n";
+  }
+
+  // RAW dependences, in the order they were found
+  if (myFormat == REPORT_TEXT || myFormat == REPORT_JSONL) {
+    const list<Dependence> &dependences = pipeline -> getDependencyChecker() -> getDependences();
+    list<Dependence>::const_iterator dep;
+    for (dep = dependences.begin(); dep != dependences.end(); dep++) {
+      if (dep -> dependenceType != RAW)
+        continue;
+      int i1Num = dep -> previousInstructionNumber;
+      int i2Num = dep -> currentInstructionNumber;
+      if (myFormat == REPORT_TEXT) {
+        myBuffer += "RAW Dependence between instruction ";
+        append(i1Num);
+        myBuffer += ' ';
+        myBuffer += insts[i1Num] -> getAssembly();
+        myBuffer += " and ";
+        append(i2Num);
+        myBuffer += ' ';
+        myBuffer += insts[i2Num] -> getAssembly();
+        myBuffer += '\n';
+      } else {
+        myBuffer += "{\"type\":\"raw\",\"pipeline\":";
+        appendJSONString(name);
+        myBuffer += ",\"producer\":";
+        append(i1Num);
+        myBuffer += ",\"consumer\":";
+        append(i2Num);
+        myBuffer += ",\"register\":";
+        append(dep -> registerNumber);
+        myBuffer += "}\n";
+      }
+      checkBuffer();
+    }
+  }
+
+  // execution time of each instruction
+  const vector<int> &rawStalls = pipeline -> getStalls(STALL_RAW);
+  const vector<int> &jumpStalls = pipeline -> getStalls(STALL_JUMP);
+  const vector<int> &structuralStalls = pipeline -> getStalls(STALL_STRUCTURAL);
+  bool withStalls = stallsRecorded && (long long)rawStalls.size() == numInstructions;
+  long long totals[NUMSTALLCAUSES] = { 0 };
+
+  if (myFormat == REPORT_TEXT) {
+    myBuffer += "Instr# \t CompletionTime \t Mnemonic \n";
+  } else if (myFormat == REPORT_CSV && !myHeaderWritten) {
+    myBuffer += "pipeline,inst,completion_time,raw_stalls,jump_stalls,structural_stalls,assembly\n";
+    myHeaderWritten = true;
+  }
+  for (long long i = 0; i < numInstructions; i++) {
+    switch (myFormat) {
+    case REPORT_TEXT:
+      append(i);
+      myBuffer += '\t';
+      append(exeTimes[i]);
+      myBuffer += "\t\t\t|";
+      myBuffer += insts[i] -> getAssembly();
+      myBuffer += '\n';
+      break;
+    case REPORT_CSV:
+      appendCSVString(name);
+      myBuffer += ',';
+      append(i);
+      myBuffer += ',';
+      append(exeTimes[i]);
+      myBuffer += ',';
+      if (withStalls) {
+        append(rawStalls[i]);
+        myBuffer += ',';
+        append(jumpStalls[i]);
+        myBuffer += ',';
+        append(structuralStalls[i]);
+      } else {
+        myBuffer += ",,";
+      }
+      myBuffer += ',';
+      appendCSVString(insts[i] -> getAssembly());
+      myBuffer += '\n';
+      break;
+    case REPORT_JSONL:
+      myBuffer += "{\"type\":\"inst\",\"pipeline\":";
+      appendJSONString(name);
+      myBuffer += ",\"inst\":";
+      append(i);
+      myBuffer += ",\"time\":";
+      append(exeTimes[i]);
+      if (withStalls) {
+        myBuffer += ",\"raw_stalls\":";
+        append(rawStalls[i]);
+        myBuffer += ",\"jump_stalls\":";
+        append(jumpStalls[i]);
+        myBuffer += ",\"structural_stalls\":";
+        append(structuralStalls[i]);
+      }
+      myBuffer += ",\"assembly\":";
+      appendJSONString(insts[i] -> getAssembly());
+      myBuffer += "}\n";
+      break;
+    default:
+      break;
+    }
+    checkBuffer();
+  }
+
+  // several instructions stall in the same cycle (e.g. the ones behind one
+  // stalling for a RAW), so the stall cycles by cause are the cycles lost,
+  // each charged once: instruction i completes lag_i cycles later than with
+  // no stall at all (issued i / width cycles after the first one, and taking
+  // its latency through the stages), and the least lag of the instructions from i on grows
+  // from the one from i - 1 on by the cycles lost on i's account, which
+  // are charged to the causes i stalled for
+  if (withStalls) {
+    long long width = pipeline -> getWidth();
+    vector<long long> leastLag(numInstructions);
+    for (long long i = numInstructions - 1; i >= 0; i--) {
+      long long lag = exeTimes[i] - ((long long)pipeline -> getIdealLatency(i) + i / width);
+      leastLag[i] = (i == numInstructions - 1) ? lag : min(lag, leastLag[i + 1]);
+    }
+    for (long long i = 0; i < numInstructions; i++) {
+      long long lost = leastLag[i] - ((i == 0) ? 0 : leastLag[i - 1]);
+      Pipeline::chargeLostCycles(max(lost, 0LL), rawStalls[i], jumpStalls[i], totals);
+    }
+  }
+
+  unsigned int latency = (numInstructions == 0) ? NUMSTAGES : pipeline -> getIdealLatency(numInstructions - 1);
+  writeTotals(name, numInstructions, totalTime, withStalls ? totals : NULL, pipeline -> getWidth(),
+              latency);
+}
+
+/* writes the totals of the pipeline named name, which took totalTime to
+ * run numInstructions, issuing up to width per cycle, the last one taking
+ * latency cycles through the stages when nothing holds it up: the total
+ * time alone in text, or the CPI and the stall cycles, by cause if stalls
+ * (indexed by StallCause, adding up to the stall cycles) is not NULL;
+ * used by writePipeline(), and when only the totals are known
+ */
+void ReportWriter::writeTotals(const string &name, long long numInstructions, long long totalTime,
+                               const long long *stalls, unsigned int width,
+                               unsigned int latency) {
+  // with no stall at all, the last instruction is issued a cycle after every
+  // width instructions before it, and completes latency cycles later (more
+  // than NUMSTAGES with stages of several cycles), so the rest is stalls
+  bool withStalls = stalls != NULL;
+  long long lastIssue = (numInstructions - 1) / width;
+  long long stallCycles = (numInstructions == 0) ? 0 : totalTime - (lastIssue + latency);
+  double cpi = (numInstructions == 0) ? 0 : (double)totalTime / numInstructions;
+  if (myFormat == REPORT_TEXT) {
+    myBuffer += "Total time is ";
+    append(totalTime);
+    myBuffer += '\n';
+  } else if (myFormat == REPORT_JSONL) {
+    myBuffer += "{\"type\":\"summary\",\"pipeline\":";
+    appendJSONString(name);
+    myBuffer += ",\"instructions\":";
+    append(numInstructions);
+    myBuffer += ",\"total_time\":";
+    append(totalTime);
+    myBuffer += ",\"cpi\":";
+    appendDouble(cpi);
+    myBuffer += ",\"stall_cycles\":";
+    append(stallCycles);
+    if (withStalls) {
+      myBuffer += ",\"raw_stalls\":";
+      append(stalls[STALL_RAW]);
+      myBuffer += ",\"jump_stalls\":";
+      append(stalls[STALL_JUMP]);
+      myBuffer += ",\"structural_stalls\":";
+      append(stalls[STALL_STRUCTURAL]);
+    }
+    myBuffer += "}\n";
+  } else if (myFormat == REPORT_SUMMARY) {
+    myBuffer += name;
+    myBuffer += ": ";
+    append(numInstructions);
+    myBuffer += " instructions, total time ";
+    append(totalTime);
+    myBuffer += ", CPI ";
+    appendDouble(cpi);
+    myBuffer += ", ";
+    append(stallCycles);
+    myBuffer += " stall cycles";
+    if (withStalls) {
+      myBuffer += " (";
+      append(stalls[STALL_RAW]);
+      myBuffer += " RAW, ";
+      append(stalls[STALL_JUMP]);
+      myBuffer += " jump, ";
+      append(stalls[STALL_STRUCTURAL]);
+      myBuffer += " structural)";
+    }
+    myBuffer += '\n';
+  }
+  checkBuffer();
+}
+
+/* writes what separates the reports of two pipelines
+ */
+void ReportWriter::writeSeparator() {
+  if (myFormat == REPORT_TEXT)
+    myBuffer += '\n';
+}
+
+/* writes out the buffer to the stream (without flushing the stream)
+ */
+void ReportWriter::flush() {
+  myOut.write(myBuffer.data(), myBuffer.size());
+  myBuffer.clear();
+}
+
+/* appends the decimal digits of n to buffer
+ */
+void ReportWriter::appendInt(string &buffer, long long n) {
+  char digits[24];
+  int length = 0;
+  bool negative = n < 0;
+  unsigned long long u = negative ? -(unsigned long long)n : n;
+  do {
+    digits[length++] = '0' + u % 10;
+    u /= 10;
+  } while (u > 0);
+  if (negative)
+    buffer += '-';
+  while (length > 0) {
+    buffer += digits[--length];
+  }
+}
+
+/* returns the format named name (text, csv, jsonl or summary), and sets
+ * ok to false if there is no such format
+ */
+ReportFormat ReportWriter::getFormat(string name, bool &ok) {
+  ok = true;
+  if (name == "text")
+    return REPORT_TEXT;
+  if (name == "csv")
+    return REPORT_CSV;
+  if (name == "jsonl")
+    return REPORT_JSONL;
+  if (name == "summary")
+    return REPORT_SUMMARY;
+  ok = false;
+  return REPORT_TEXT;
+}
+
+/* appends s to the buffer, quoted and escaped for CSV / JSON
+ */
+void ReportWriter::appendCSVString(const string &s) {
+  myBuffer += '"';
+  for (unsigned int c = 0; c < s.length(); c++) {
+    if (s[c] == '"')
+      myBuffer += '"';
+    myBuffer += s[c];
+  }
+  myBuffer += '"';
+}
+
+void ReportWriter::appendJSONString(const string &s) {
+  myBuffer += '"';
+  for (unsigned int c = 0; c < s.length(); c++) {
+    if (s[c] == '"' || s[c] == '\\') {
+      myBuffer += '\\';
+      myBuffer += s[c];
+    } else if ((unsigned char)s[c] < 0x20) {
+      myBuffer += ' ';
+    } else {
+      myBuffer += s[c];
+    }
+  }
+  myBuffer += '"';
+}
+
+/* appends the decimal digits of d to the buffer, as cout would print it
+ * (e.g. the CPI)
+ */
+void ReportWriter::appendDouble(double d) {
+  char digits[32];
+  int length = snprintf(digits, sizeof(digits), "%g", d);
+  myBuffer.append(digits, length);
+}
@@ -0,0 +1,104 @@
+// Name: Maxine Xin
+#ifndef __REPORTWRITER_H__
+#define __REPORTWRITER_H__
+
+#include <iostream>
+#include <string>
+
+#include "Pipeline.h"
+
+using namespace std;
+
+// formats of the report of a pipeline
+enum ReportFormat {
+  REPORT_TEXT,      // same as Pipeline::print()
+  REPORT_CSV,       // one row per instruction
+  REPORT_JSONL,     // one JSON object per line, per dependence / instruction / pipeline
+  REPORT_SUMMARY    // one line per pipeline, with the totals only
+};
+
+/* This class writes the report of each pipeline (RAW dependences, execution
+ * time of each instruction, total time) in one of the formats above.
+ *
+ * Everything goes through a large buffer, which is only written out to the
+ * stream when it is full or when flush() is called, numbers are formatted
+ * by hand, and the instructions are looked up by index, so that writing
+ * the report takes time linear in the number of instructions and
+ * dependences.
+ */
+class ReportWriter {
+  public:
+    /* writes to out, in format
+     */
+    ReportWriter(ostream &out, ReportFormat format);
+
+    /* writes out what is left in the buffer
+     */
+    ~ReportWriter();
+
+    /* writes the report of pipeline, which has run; stallsRecorded tells
+     * whether the pipeline recorded its stalls (i.e. simulated every cycle),
+     * otherwise only the total stall cycles are known
+     */
+    void writePipeline(Pipeline *pipeline, bool stallsRecorded);
+
+    /* writes the totals of the pipeline named name, which took totalTime to
+     * run numInstructions, issuing up to width per cycle, the last one taking
+     * latency cycles through the stages when nothing holds it up: the total
+     * time alone in text, or the CPI and the stall cycles, by cause if stalls
+     * (indexed by StallCause, adding up to the stall cycles) is not NULL;
+     * used by writePipeline(), and when only the totals are known
+     */
+    void writeTotals(const string &name, long long numInstructions, long long totalTime,
+                     const long long *stalls, unsigned int width = 1,
+                     unsigned int latency = NUMSTAGES);
+
+    /* writes what separates the reports of two pipelines
+     */
+    void writeSeparator();
+
+    /* writes out the buffer to the stream (without flushing the stream)
+     */
+    void flush();
+
+    /* returns the bytes held by the writer, mostly its buffer
+     */
+    size_t getMemoryUsage() const { 
+      return sizeof(*this) + MemoryAccount::stringBytes(myBuffer); 
+    };
+
+    /* appends the decimal digits of n to buffer
+     */
+    static void appendInt(string &buffer, long long n);
+
+    /* returns the format named name (text, csv, jsonl or summary), and sets
+     * ok to false if there is no such format
+     */
+    static ReportFormat getFormat(string name, bool &ok);
+
+  private:
+    /* appends s to the buffer, quoted and escaped for CSV / JSON
+     */
+    void appendCSVString(const string &s);
+    void appendJSONString(const string &s);
+
+    /* appends the decimal digits of n / of d (as cout would print it, e.g.
+     * the CPI) to the buffer
+     */
+    void append(long long n) { appendInt(myBuffer, n); };
+    void appendDouble(double d);
+
+    /* writes out the buffer if it is full
+     */
+    void checkBuffer() { if (myBuffer.size() >= BUFFER_SIZE) flush(); };
+
+    // the buffer is written out once it holds that many bytes
+    const static size_t BUFFER_SIZE = 1 << 20;
+
+    ostream &myOut;
+    ReportFormat myFormat;
+    string myBuffer;
+    bool myHeaderWritten;      // whether the header of the CSV has been written
+};
+
+#endif
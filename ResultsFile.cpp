@@ -0,0 +1,158 @@
+// Name: Maxine Xin
+#include "ResultsFile.h"
+
+#include <cstring>
+
+/* opens filename for writing
+ */
+ResultsFile::ResultsFile(string filename) {
+  myFile = fopen(filename.c_str(), "wb");
+  myBuffer.resize(BUFFER_SIZE);
+  myBufferSize = 0;
+  myOffset = 0;
+  myFailed = false;
+}
+
+/* closes the file, if not done yet
+ */
+ResultsFile::~ResultsFile() {
+  if (myFile != NULL)
+    fclose(myFile);
+}
+
+/* writes the results of the instructions in each pipeline, which have
+ * run; stallsRecorded tells whether the pipelines recorded their stalls
+ * (i.e. simulated every cycle); returns false if the file could not be
+ * written
+ */
+bool ResultsFile::write(const vector<Instruction> &instructions, vector<Pipeline*> &pipelines,
+                        bool stallsRecorded) {
+  if (myFile == NULL)
+    return false;
+  uint64_t numRows = instructions.size();
+
+  // the stalls are only written if every pipeline has them for every instruction
+  for (unsigned int p = 0; p < pipelines.size(); p++) {
+    if (pipelines[p] -> getStalls(STALL_RAW).size() != numRows)
+      stallsRecorded = false;
+  }
+
+  // describe the columns, each starting at the next aligned offset
+  vector<ColumnInfo> columns;
+  ColumnInfo column;
+  memset(&column, 0, sizeof(column));
+  strncpy(column.name, "inst", sizeof(column.name) - 1);
+  column.type = COLUMN_UINT32;
+  column.elementSize = sizeof(uint32_t);
+  columns.push_back(column);
+  strncpy(column.name, "opcode", sizeof(column.name) - 1);
+  column.type = COLUMN_UINT8;
+  column.elementSize = sizeof(uint8_t);
+  columns.push_back(column);
+  for (unsigned int p = 0; p < pipelines.size(); p++) {
+    memset(column.name, 0, sizeof(column.name));
+    strncpy(column.name, (pipelines[p] -> getName() + ".time").c_str(), sizeof(column.name) - 1);
+    column.type = COLUMN_INT32;
+    column.elementSize = sizeof(int32_t);
+    columns.push_back(column);
+    if (stallsRecorded) {
+      memset(column.name, 0, sizeof(column.name));
+      strncpy(column.name, (pipelines[p] -> getName() + ".stalls").c_str(), sizeof(column.name) - 1);
+      columns.push_back(column);
+    }
+  }
+
+  ResultsHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "PIPERES", 8);
+  header.version = 1;
+  header.numColumns = columns.size();
+  header.numRows = numRows;
+  uint64_t offset = sizeof(ResultsHeader) + columns.size() * sizeof(ColumnInfo);
+  offset = (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  header.headerSize = offset;
+  for (unsigned int c = 0; c < columns.size(); c++) {
+    columns[c].offset = offset;
+    offset += numRows * columns[c].elementSize;
+    offset = (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  }
+
+  append(&header, sizeof(header));
+  append(columns.data(), columns.size() * sizeof(ColumnInfo));
+  pad(ALIGNMENT);
+
+  // inst and opcode
+  for (uint64_t i = 0; i < numRows; i++) {
+    uint32_t inst = i;
+    append(&inst, sizeof(inst));
+  }
+  pad(ALIGNMENT);
+  for (uint64_t i = 0; i < numRows; i++) {
+    uint8_t opcode = instructions[i].getOpcode();
+    append(&opcode, sizeof(opcode));
+  }
+  pad(ALIGNMENT);
+
+  // completion time and stalls in each pipeline
+  for (unsigned int p = 0; p < pipelines.size(); p++) {
+    const vector<int> &exeTimes = pipelines[p] -> getExeTimes();
+    for (uint64_t i = 0; i < numRows; i++) {
+      int32_t time = exeTimes[i];
+      append(&time, sizeof(time));
+    }
+    pad(ALIGNMENT);
+    if (!stallsRecorded)
+      continue;
+    const vector<int> &rawStalls = pipelines[p] -> getStalls(STALL_RAW);
+    const vector<int> &jumpStalls = pipelines[p] -> getStalls(STALL_JUMP);
+    const vector<int> &structuralStalls = pipelines[p] -> getStalls(STALL_STRUCTURAL);
+    for (uint64_t i = 0; i < numRows; i++) {
+      int32_t stalls = rawStalls[i] + jumpStalls[i] + structuralStalls[i];
+      append(&stalls, sizeof(stalls));
+    }
+    pad(ALIGNMENT);
+  }
+
+  flush();
+  if (fclose(myFile) != 0)
+    myFailed = true;
+  myFile = NULL;
+  return !myFailed && myOffset == offset;
+}
+
+/* appends size bytes at data to the buffer, writing it out when full
+ */
+void ResultsFile::append(const void *data, size_t size) {
+  if (myBufferSize + size > BUFFER_SIZE)
+    flush();
+  if (size > BUFFER_SIZE) {
+    if (fwrite(data, 1, size, myFile) != size)
+      myFailed = true;
+  } else {
+    memcpy(&myBuffer[myBufferSize], data, size);
+    myBufferSize += size;
+  }
+  myOffset += size;
+}
+
+/* appends zeros up to the next offset that is a multiple of alignment
+ */
+void ResultsFile::pad(uint64_t alignment) {
+  static const char zeros[64] = { 0 };
+  while (myOffset % alignment != 0) {
+    uint64_t size = alignment - myOffset % alignment;
+    if (size > sizeof(zeros))
+      size = sizeof(zeros);
+    append(zeros, size);
+  }
+}
+
+/* writes out the buffer
+ */
+void ResultsFile::flush() {
+  if (myBufferSize == 0)
+    return;
+  if (fwrite(myBuffer.data(), 1, myBufferSize, myFile) != myBufferSize)
+    myFailed = true;
+  myBufferSize = 0;
+}
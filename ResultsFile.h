@@ -0,0 +1,107 @@
+// Name: Maxine Xin
+#ifndef __RESULTSFILE_H__
+#define __RESULTSFILE_H__
+
+#include <cstdio>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "Pipeline.h"
+
+using namespace std;
+
+// type of the values of a column
+enum ColumnType {
+  COLUMN_UINT8 = 1,
+  COLUMN_INT32 = 2,
+  COLUMN_UINT32 = 3
+};
+
+/* The header at the beginning of a results file, followed by numColumns
+ * ColumnInfo, all in native (little-endian) byte order.
+ */
+struct ResultsHeader {
+  char magic[8];             // "PIPERES" followed by '\0'
+  uint32_t version;          // 1
+  uint32_t numColumns;
+  uint64_t numRows;          // number of instructions
+  uint64_t headerSize;       // bytes before the first column
+};
+
+/* Where a column is in a results file: numRows values of elementSize bytes
+ * each, starting at byte offset of the file (a multiple of 64).
+ */
+struct ColumnInfo {
+  char name[24];             // e.g. "inst", "opcode", "STALL.time", '\0' terminated
+  uint32_t type;             // a ColumnType
+  uint32_t elementSize;
+  uint64_t offset;
+};
+
+/* This class writes the results of the pipelines as a columnar binary file,
+ * which can be memory-mapped and used as arrays without any parsing: the
+ * header, the ColumnInfo of each column, then each column, one after the
+ * other. The columns are:
+ *   inst: number of each instruction (uint32)
+ *   opcode: Opcode of each instruction, as numbered in OpcodeTable.h (uint8)
+ *   <pipeline>.time: completion time of each instruction (int32)
+ *   <pipeline>.stalls: cycles each instruction stalled, for any cause (int32),
+ *                      only if the pipelines recorded their stalls
+ *
+ * The file is written in order, through a large buffer.
+ */
+class ResultsFile {
+  public:
+    /* opens filename for writing
+     */
+    ResultsFile(string filename);
+
+    /* closes the file, if not done yet
+     */
+    ~ResultsFile();
+
+    /* returns false if the file could not be opened
+     */
+    bool isOpen() { return myFile != NULL; };
+
+    /* returns the bytes held by the writer, mostly its buffer
+     */
+    size_t getMemoryUsage() const { 
+      return sizeof(*this) + MemoryAccount::vectorBytes(myBuffer); 
+    };
+
+    /* writes the results of the instructions in each pipeline, which have
+     * run; stallsRecorded tells whether the pipelines recorded their stalls
+     * (i.e. simulated every cycle); returns false if the file could not be
+     * written
+     */
+    bool write(const vector<Instruction> &instructions, vector<Pipeline*> &pipelines,
+               bool stallsRecorded);
+
+  private:
+    /* appends size bytes at data to the buffer, writing it out when full
+     */
+    void append(const void *data, size_t size);
+
+    /* appends zeros up to the next offset that is a multiple of alignment
+     */
+    void pad(uint64_t alignment);
+
+    /* writes out the buffer
+     */
+    void flush();
+
+    // the buffer is written out once it holds that many bytes
+    const static size_t BUFFER_SIZE = 1 << 22;
+    // columns start at offsets that are multiples of this
+    const static uint64_t ALIGNMENT = 64;
+
+    FILE *myFile;
+    vector<char> myBuffer;
+    size_t myBufferSize;       // bytes in the buffer
+    uint64_t myOffset;         // bytes appended so far
+    bool myFailed;
+};
+
+#endif
@@ -0,0 +1,138 @@
+// Name: Maxine Xin
+#include "SampledSimulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+// the estimate is within myConfidence of the total time with a 95% probability
+static const double Z95 = 1.96;
+
+/* numSamples: number of units simulated in detail
+ * sampleSize: number of fetches in each unit
+ * warmup: number of instructions simulated before each unit
+ * random: if true, the units are picked at random (with seed), otherwise
+ *         they are evenly spread over the instructions
+ */
+SampledSimulation::SampledSimulation(unsigned int numSamples, unsigned int sampleSize,
+                                     unsigned int warmup, bool random, unsigned int seed) {
+  myNumSamples = max(1u, numSamples);
+  mySampleSize = max(1u, sampleSize);
+  // a hazard is between instructions less than NUMSTAGES apart, so it takes
+  // at least that many instructions for the warm-up to hold the ones that
+  // can stall the first instruction of the unit
+  myWarmup = max(warmup, (unsigned int)NUMSTAGES);
+  myRandom = random;
+  mySeed = seed;
+  myTotalTime = 0;
+  myConfidence = 0;
+  myCPI = 0;
+  myNumSampled = 0;
+  myNumSimulated = 0;
+}
+
+/* estimates the total time of the instructions on a pipeline of the same
+ * kind as kind (which is only used to create such pipelines)
+ */
+void SampledSimulation::execute(Pipeline *kind, const vector<Instruction> &instructions) {
+  unsigned int numInstructions = instructions.size();
+  myTotalTime = 0;
+  myConfidence = 0;
+  myCPI = 0;
+  myNumSampled = 0;
+  myNumSimulated = 0;
+  if (numInstructions == 0)
+    return;
+
+  // the total time is the time right after the first instruction is fetched,
+  // plus the cycles between each fetch and the next one, plus the time the
+  // last instruction takes to go through the pipeline; the units are made of
+  // the gaps between fetches, which are the only part that is estimated
+  unsigned int numGaps = numInstructions - 1;
+  unsigned int numUnits = numGaps / mySampleSize;
+
+  if (numUnits <= myNumSamples ||
+      (unsigned long long)myNumSamples * (mySampleSize + myWarmup) >= numInstructions) {
+    // sampling would not save anything, simulate the whole thing
+    Pipeline *pipeline = kind->createEmpty();
+    pipeline->initialize(instructions);
+    pipeline->execute();
+    vector<int> exeTimes = pipeline->getExeTimes();
+    delete pipeline;
+    myTotalTime = exeTimes.back();
+    myCPI = myTotalTime / (double)numInstructions;
+    myNumSampled = 0;
+    myNumSimulated = numInstructions;
+    return;
+  }
+
+  // cycles per gap in each unit picked
+  vector<unsigned int> units = pickUnits(numUnits);
+  double sum = 0;
+  double sumOfSquares = 0;
+  for (unsigned int u = 0; u < units.size(); u++) {
+    unsigned int begin = units[u] * mySampleSize;
+    double cycles = simulateUnit(kind, instructions, begin, begin + mySampleSize);
+    double perGap = cycles / mySampleSize;
+    sum += perGap;
+    sumOfSquares += perGap * perGap;
+  }
+  myNumSampled = units.size();
+
+  // extrapolate the mean to all gaps; the variance among the samples gives
+  // the standard error of the mean, reduced as the samples cover more of
+  // the units (finite population correction)
+  double mean = sum / myNumSampled;
+  myTotalTime = 1 + mean * numGaps + (NUMSTAGES - 1);
+  if (myNumSampled >= 2) {
+    double variance = max(0.0, (sumOfSquares - sum * mean) / (myNumSampled - 1));
+    double correction = 1 - (double)myNumSampled / numUnits;
+    myConfidence = Z95 * numGaps * sqrt(variance / myNumSampled * correction);
+  }
+  myCPI = myTotalTime / numInstructions;
+}
+
+/* returns the units to simulate, in order, out of numUnits
+ */
+vector<unsigned int> SampledSimulation::pickUnits(unsigned int numUnits) {
+  vector<unsigned int> units;
+  if (!myRandom) {
+    // one unit in the middle of each of myNumSamples equal parts
+    for (unsigned int s = 0; s < myNumSamples; s++) {
+      units.push_back((unsigned int)((s + 0.5) * numUnits / myNumSamples));
+    }
+    return units;
+  }
+
+  // selection sampling: go through the units in order, picking each one
+  // with probability (number still needed) / (number still left)
+  mt19937 generator(mySeed);
+  uniform_real_distribution<double> uniform(0.0, 1.0);
+  unsigned int needed = myNumSamples;
+  for (unsigned int u = 0; u < numUnits && needed > 0; u++) {
+    if (uniform(generator) * (numUnits - u) < needed) {
+      units.push_back(u);
+      needed--;
+    }
+  }
+  return units;
+}
+
+/* returns the number of cycles between the fetch of instruction begin
+ * and the fetch of instruction end, simulated on a pipeline of the same
+ * kind as kind that starts empty myWarmup instructions before begin
+ */
+int SampledSimulation::simulateUnit(Pipeline *kind, const vector<Instruction> &instructions,
+                                    unsigned int begin, unsigned int end) {
+  unsigned int base = (begin > myWarmup) ? begin - myWarmup : 0;
+  Pipeline *pipeline = kind->createEmpty();
+  pipeline->initialize(vector<Instruction>(instructions.begin() + base,
+                                           instructions.begin() + end + 1));
+  PipelineState state = pipeline->run(pipeline->getEmptyState(), begin - base);
+  int start = state.time;
+  state = pipeline->run(state, end - base);
+  delete pipeline;
+
+  myNumSimulated += end + 1 - base;
+  return state.time - start;
+}
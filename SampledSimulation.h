@@ -0,0 +1,85 @@
+// Name: Maxine Xin
+#ifndef __SAMPLEDSIMULATION_H__
+#define __SAMPLEDSIMULATION_H__
+
+#include <vector>
+
+#include "Pipeline.h"
+
+using namespace std;
+
+/* This class estimates the total time of a (very long) list of instructions
+ * on a kind of Pipeline by only simulating samples of it in detail.
+ *
+ * The instructions are split into units of sampleSize consecutive fetches;
+ * numSamples units are picked, either periodically or at random, and each is
+ * simulated on a pipeline of the same kind that only holds the unit and the
+ * warm-up instructions before it. The pipelines keep no state other than the
+ * instructions they hold, so nothing needs to be done for the instructions in
+ * between, other than analysing the dependences of the ones a sample holds.
+ *
+ * The number of cycles between two fetches is averaged over the samples, and
+ * extrapolated to the whole list of instructions, along with a confidence
+ * interval computed from the variance among the samples.
+ */
+class SampledSimulation {
+  public:
+    /* numSamples: number of units simulated in detail
+     * sampleSize: number of fetches in each unit
+     * warmup: number of instructions simulated before each unit
+     * random: if true, the units are picked at random (with seed), otherwise
+     *         they are evenly spread over the instructions
+     */
+    SampledSimulation(unsigned int numSamples, unsigned int sampleSize = 1000,
+                      unsigned int warmup = 2 * NUMSTAGES, bool random = false,
+                      unsigned int seed = 1);
+
+    /* estimates the total time of the instructions on a pipeline of the same
+     * kind as kind (which is only used to create such pipelines)
+     */
+    void execute(Pipeline *kind, const vector<Instruction> &instructions);
+
+    /* returns the estimated total time, and the half-width of its 95%
+     * confidence interval (0 if every unit was simulated, or if there
+     * were less than two samples)
+     */
+    double getTotalTime() { return myTotalTime; };
+    double getConfidence() { return myConfidence; };
+
+    /* returns the estimated number of cycles per instruction
+     */
+    double getCPI() { return myCPI; };
+
+    /* returns the number of units simulated in detail (0 if sampling would
+     * not have saved anything, and the whole list was simulated instead), and
+     * the number of instructions fetched to do so (warm-ups included)
+     */
+    unsigned int getNumSamples() { return myNumSampled; };
+    unsigned long long getNumSimulated() { return myNumSimulated; };
+
+  private:
+    /* returns the units to simulate, in order, out of numUnits
+     */
+    vector<unsigned int> pickUnits(unsigned int numUnits);
+
+    /* returns the number of cycles between the fetch of instruction begin
+     * and the fetch of instruction end, simulated on a pipeline of the same
+     * kind as kind that starts empty myWarmup instructions before begin
+     */
+    int simulateUnit(Pipeline *kind, const vector<Instruction> &instructions,
+                     unsigned int begin, unsigned int end);
+
+    unsigned int myNumSamples;
+    unsigned int mySampleSize;
+    unsigned int myWarmup;
+    bool myRandom;
+    unsigned int mySeed;
+
+    double myTotalTime;
+    double myConfidence;
+    double myCPI;
+    unsigned int myNumSampled;
+    unsigned long long myNumSimulated;
+};
+
+#endif
@@ -8,6 +8,25 @@ StallPipeline::StallPipeline() : Pipeline() {
   myName = "STALL";
 }
 
+/* returns a newly allocated, uninitialized StallPipeline
+ */
+Pipeline *StallPipeline::createEmpty() {
+  return new StallPipeline();
+}
+
+/* returns the stages that decide when the stall pipeline stalls
+ */
+PipelineConfig StallPipeline::getConfig() {
+  PipelineConfig config;
+  config.operandNeeded = MY_STAGE_OPERAND_NEEDED;
+  config.operandProducedMemory = MY_STAGE_OPERAND_PRODUCED;
+  config.operandProducedOther = MY_STAGE_OPERAND_PRODUCED;
+  config.forwarding = false;
+  config.jumpDestProduced = MY_STAGE_JUMP_DEST_PRODUCED;
+  config.forwardPaths = FORWARD_BY_STAGES;
+  return config;
+}
+
 /* given a Stage index st, returns true if the instruction in the
  * preceding stage / the instruction to be fetched
  * can be moved into Stage st, returns false if otherwise 
@@ -15,8 +34,10 @@ StallPipeline::StallPipeline() : Pipeline() {
  */
 bool StallPipeline::canMoveIntoStage(int st) {
   // if stage is currently occupied
-  if (myStageEntry[st] != myStageEmpty)
+  if (myStageEntry[st] != myStageEmpty) {
+    myStallCause = STALL_STRUCTURAL;
     return false;
+  }
 
   // if the stage where operand is needed is not the previous stage of
   // the current stage, the current stage should be able to get instruction
@@ -31,14 +52,12 @@ bool StallPipeline::canMoveIntoStage(int st) {
         stAffectedByJump <= MY_STAGE_JUMP_DEST_PRODUCED; stAffectedByJump++) {
         if (myStageEntry[stAffectedByJump] != myStageEmpty) {
           // if myStageEntry[stAffectedByJump] is not empty,
-          // get that instruction
-          list<Instruction>::iterator it = myInstructions.begin();
-          advance(it, myStageEntry[stAffectedByJump]);
-
-          // if that inst is a jump inst, no inst can be fetched,
+          // and that inst is a jump inst, no inst can be fetched,
           // so cannot move into the first stage, return false
-          if (myOpcodeTable.isIMMLabel((*it).getOpcode()))
+          if (myOpcodeTable.isIMMLabel(myOpcodes[myStageEntry[stAffectedByJump]])) {
+            myStallCause = STALL_JUMP;
             return false;
+          }
         }
       }
     }
@@ -56,6 +75,8 @@ bool StallPipeline::canMoveIntoStage(int st) {
       if (myDepChecker.isRAW(myStageEntry[influenceSt], myStageEntry[st - 1])) {
         // if there is an RAW dependency, there is a stall such that the instruction
         // in the previous stage cannot be moved into the current stage so return false
+        myStallCause = STALL_RAW;
+        myStallProducer = myStageEntry[influenceSt];
         return false;
       }
     }
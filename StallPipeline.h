@@ -15,6 +15,14 @@ class StallPipeline : public Pipeline {
     */
    ~StallPipeline() {}; 
 
+   /* returns a newly allocated, uninitialized StallPipeline
+    */
+   Pipeline *createEmpty();
+
+   /* returns the stages that decide when the stall pipeline stalls
+    */
+   PipelineConfig getConfig();
+
   private: 
     /* given a Stage index st, returns true if the instruction in the
      * preceding stage / the instruction to be fetched 
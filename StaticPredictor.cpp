@@ -0,0 +1,25 @@
+// Name: Maxine Xin
+#include "StaticPredictor.h"
+
+/* creates a predictor
+ */
+StaticPredictor::StaticPredictor() {
+  myName = "nottaken";
+}
+
+/* returns false: every branch is predicted not taken
+ */
+bool StaticPredictor::predict(uint32_t pc) {
+  return false;
+}
+
+/* learns nothing from the outcome of a branch
+ */
+void StaticPredictor::update(uint32_t pc, bool taken, uint32_t target) {
+}
+
+/* returns the bytes held by the predictor
+ */
+size_t StaticPredictor::getMemoryUsage() const {
+  return sizeof(*this);
+}
@@ -0,0 +1,29 @@
+// Name: Maxine Xin
+#ifndef __STATICPREDICTOR_H__
+#define __STATICPREDICTOR_H__
+
+#include "BranchPredictor.h"
+
+/* This class predicts every branch not taken, so that fetching goes on
+ * with the next instruction, and holds nothing.
+ */
+class StaticPredictor : public BranchPredictor {
+  public:
+    /* creates a predictor
+     */
+    StaticPredictor();
+
+    /* returns false: every branch is predicted not taken
+     */
+    bool predict(uint32_t pc);
+
+    /* learns nothing from the outcome of a branch
+     */
+    void update(uint32_t pc, bool taken, uint32_t target);
+
+    /* returns the bytes held by the predictor
+     */
+    size_t getMemoryUsage() const;
+};
+
+#endif
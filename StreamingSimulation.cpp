@@ -0,0 +1,101 @@
+// Name: Maxine Xin
+#include "StreamingSimulation.h"
+
+/* windowSize: number of instructions of each window
+ */
+StreamingSimulation::StreamingSimulation(unsigned int windowSize) {
+  myWindowSize = windowSize;
+  if (myWindowSize == 0)
+    myWindowSize = 1;
+  myTotalTime = 0;
+  for (int cause = 0; cause < NUMSTALLCAUSES; cause++) {
+    myStalls[cause] = 0;
+  }
+  myNumWindows = 0;
+  myPeakMemoryUsage = 0;
+}
+
+/* simulates the instructions on pipelines of the same kind as pipeline,
+ * which is left as it is
+ */
+void StreamingSimulation::execute(Pipeline *pipeline, const vector<Instruction> &instructions) {
+  unsigned int numInstructions = instructions.size();
+  myTotalTime = 0;
+  for (int cause = 0; cause < NUMSTALLCAUSES; cause++) {
+    myStalls[cause] = 0;
+  }
+  myNumWindows = 0;
+  myPeakMemoryUsage = 0;
+
+  PipelineState state = pipeline->getEmptyState();   // global numbers
+  unsigned int begin = 0;
+  // the stall cycles are the cycles lost, charged as ReportWriter does: with
+  // a pipeline of width 1, those by which each inst completes after the one
+  // before it plus a cycle; an inst still in the pipeline when a window
+  // stops carries the cycles it stalled so far over to the next window
+  int lastCompleted = NUMSTAGES - 1;
+  vector<int> carried[NUMSTALLCAUSES];   // of each inst from the next window's base on
+  while (begin < numInstructions) {
+    // the window holds every inst still in the pipeline, which are all
+    // after the oldest one in a stage
+    unsigned int base = begin;
+    for (int st = 0; st < NUMSTAGES; st++) {
+      if (state.stageEntry[st] != -1 && (unsigned int)state.stageEntry[st] < base)
+        base = state.stageEntry[st];
+    }
+    unsigned int end = begin + min(myWindowSize, numInstructions - begin);
+    unsigned int last = min(end + 1, numInstructions);
+    vector<Instruction> held(instructions.begin() + base, instructions.begin() + last);
+    Pipeline *window = pipeline->createEmpty();
+    window->initialize(held);
+
+    vector<int> completed;
+    PipelineState local = state;
+    for (int st = 0; st < NUMSTAGES; st++) {
+      if (local.stageEntry[st] != -1)
+        local.stageEntry[st] -= base;
+    }
+    local.nextFetch -= base;
+    if (end < numInstructions) {
+      // stop once the first inst of the next window is fetched
+      local = window->run(local, end - base, &completed);
+      state = local;
+      for (int st = 0; st < NUMSTAGES; st++) {
+        if (state.stageEntry[st] != -1)
+          state.stageEntry[st] += base;
+      }
+      state.nextFetch += base;
+    } else {
+      window->run(local, window->getNumInstructions(), &completed);
+      myTotalTime = window->getExeTimes().back();
+    }
+
+    // each cycle an inst stalled is only recorded by the window simulating
+    // it; the insts completed are the oldest ones, from base on
+    vector<int> stillCarried[NUMSTALLCAUSES];
+    for (unsigned int i = 0; i < held.size(); i++) {
+      int stalls[NUMSTALLCAUSES];
+      for (int cause = 0; cause < NUMSTALLCAUSES; cause++) {
+        stalls[cause] = window->getStalls((StallCause)cause)[i];
+        if (i < carried[cause].size())
+          stalls[cause] += carried[cause][i];
+      }
+      if (i < completed.size()) {
+        Pipeline::chargeLostCycles(completed[i] - lastCompleted - 1, stalls[STALL_RAW],
+                                   stalls[STALL_JUMP], myStalls);
+        lastCompleted = completed[i];
+      } else {
+        for (int cause = 0; cause < NUMSTALLCAUSES; cause++) {
+          stillCarried[cause].push_back(stalls[cause]);
+        }
+      }
+    }
+    for (int cause = 0; cause < NUMSTALLCAUSES; cause++) {
+      carried[cause].swap(stillCarried[cause]);
+    }
+    myPeakMemoryUsage = max(myPeakMemoryUsage, window->getMemoryUsage());
+    delete window;
+    myNumWindows++;
+    begin = end;
+  }
+}
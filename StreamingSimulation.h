@@ -0,0 +1,53 @@
+// Name: Maxine Xin
+#ifndef __STREAMINGSIMULATION_H__
+#define __STREAMINGSIMULATION_H__
+
+#include <vector>
+
+#include "Pipeline.h"
+
+using namespace std;
+
+/* This class simulates one list of instructions on a Pipeline one window
+ * of instructions at a time, keeping only the totals (total time and stall
+ * cycles of each cause), so that the memory it needs does not grow with
+ * the number of instructions.
+ *
+ * Each window is simulated by a fresh pipeline of the same kind, holding
+ * the instructions still in the pipeline when the last window stopped, the
+ * window itself, and the first instruction of the next window, whose fetch
+ * ends the window; it resumes from the state the last window reached, as
+ * ChunkedSimulation does when a chunk has to be simulated again, and is
+ * deleted before the next one is built. Since a hazard only involves
+ * instructions that are in the pipeline at the same time, the result is
+ * the same as the one of Pipeline::execute().
+ */
+class StreamingSimulation {
+  public:
+    /* windowSize: number of instructions of each window
+     */
+    StreamingSimulation(unsigned int windowSize = 4096);
+
+    /* simulates the instructions on pipelines of the same kind as pipeline,
+     * which is left as it is
+     */
+    void execute(Pipeline *pipeline, const vector<Instruction> &instructions);
+
+    /* returns, for the last call to execute(), the completion time of the
+     * last instruction, the stall cycles for cause, the number of windows
+     * simulated, and the most bytes held by the pipeline of a window
+     */
+    long long getTotalTime() { return myTotalTime; };
+    long long getStalls(StallCause cause) { return myStalls[cause]; };
+    unsigned int getNumWindows() { return myNumWindows; };
+    size_t getPeakMemoryUsage() { return myPeakMemoryUsage; };
+
+  private:
+    unsigned int myWindowSize;
+    long long myTotalTime;
+    long long myStalls[NUMSTALLCAUSES];
+    unsigned int myNumWindows;
+    size_t myPeakMemoryUsage;
+};
+
+#endif
@@ -0,0 +1,454 @@
+// Name: Maxine Xin
+#include "SuperscalarPipeline.h"
+
+#include <cstdlib>
+#include <sstream>
+
+// names of the stages and functional units in the lists read
+static const char *STAGE_NAMES[NUMSTAGES] = { "if", "id", "ex", "mem", "wb" };
+static const char *UNIT_NAMES[NUMUNITS] = { "mem", "mult" };
+
+/* creates a pipeline of width W, stalling as one with config does,
+ * named name, with one of each functional unit
+ */
+SuperscalarPipeline::SuperscalarPipeline(const PipelineConfig &config, string name,
+                                         unsigned int width) : Pipeline() {
+  myName = name;
+  myConfig = config;
+  myWidth = (width == 0) ? 1 : width;
+  for (int unit = 0; unit < NUMUNITS; unit++) {
+    myNumUnits[unit] = 1;
+    myPipelined[unit] = false;
+  }
+  for (int op = 0; op <= UNDEFINED; op++) {
+    for (int st = 0; st < NUMSTAGES; st++) {
+      myCycles[op][st] = 1;
+    }
+  }
+  myFetchQueueSize = 0;
+  myTime = 0;
+  myMissInst = -1;
+  myMissDoneTime = 0;
+  myNumFrontEndBound = 0;
+  myNumBackEndBound = 0;
+}
+
+/* sets the number of functional units of kind unit (at least 1)
+ */
+void SuperscalarPipeline::setNumUnits(FunctionalUnit unit, unsigned int count) {
+  myNumUnits[unit] = (count == 0) ? 1 : count;
+}
+
+/* sets whether functional unit unit is pipelined (takes a new
+ * instruction every cycle) or not (only one at a time, the default)
+ */
+void SuperscalarPipeline::setPipelined(FunctionalUnit unit, bool pipelined) {
+  myPipelined[unit] = pipelined;
+}
+
+/* sets the number of cycles (at least 1) every instruction spends in
+ * stage st, or the instructions of opcode op
+ */
+void SuperscalarPipeline::setStageCycles(int st, unsigned int cycles) {
+  for (int op = 0; op <= UNDEFINED; op++) {
+    setCycles((Opcode)op, st, cycles);
+  }
+}
+
+void SuperscalarPipeline::setCycles(Opcode op, int st, unsigned int cycles) {
+  myCycles[op][st] = (cycles == 0) ? 1 : cycles;
+}
+
+/* sets the cycles of each stage from list (e.g. ex=3,mem=2), or of
+ * each opcode from list (e.g. mult=4,lb=3), in EXECUTE, or MEMORY for a
+ * load; returns false if list cannot be read
+ */
+bool SuperscalarPipeline::setStageCycles(const string &list) {
+  stringstream ss(list);
+  string item;
+  while (getline(ss, item, ',')) {
+    string::size_type equal = item.find('=');
+    if (equal == string::npos)
+      return false;
+    int cycles = atoi(item.substr(equal + 1).c_str());
+    int st = 0;
+    while (st < NUMSTAGES && item.substr(0, equal) != STAGE_NAMES[st]) {
+      st++;
+    }
+    if (st == NUMSTAGES || cycles <= 0)
+      return false;
+    setStageCycles(st, cycles);
+  }
+  return true;
+}
+
+bool SuperscalarPipeline::setLatencies(const string &list) {
+  stringstream ss(list);
+  string item;
+  while (getline(ss, item, ',')) {
+    string::size_type equal = item.find('=');
+    if (equal == string::npos)
+      return false;
+    int cycles = atoi(item.substr(equal + 1).c_str());
+    Opcode op = myOpcodeTable.getOpcode(item.substr(0, equal));
+    if (op == UNDEFINED || cycles <= 0)
+      return false;
+    setCycles(op, myOpcodeTable.isIMMMemory(op) ? MEMORY : EXECUTE, cycles);
+  }
+  return true;
+}
+
+/* sets the pipelined functional units from list (e.g. mult,mem);
+ * returns false if list cannot be read
+ */
+bool SuperscalarPipeline::setPipelinedUnits(const string &list) {
+  stringstream ss(list);
+  string item;
+  while (getline(ss, item, ',')) {
+    int unit = 0;
+    while (unit < NUMUNITS && item != UNIT_NAMES[unit]) {
+      unit++;
+    }
+    if (unit == NUMUNITS)
+      return false;
+    setPipelined((FunctionalUnit)unit, true);
+  }
+  return true;
+}
+
+/* sets the cycles each instruction spends in MEMORY, e.g. as decided by
+ * a DataCache for each load, over those of its opcode (0 keeps them)
+ */
+void SuperscalarPipeline::setMemoryCycles(const vector<unsigned int> &cycles) {
+  myMemoryCycles = cycles;
+}
+
+/* sets the cycles an I-cache miss holds up fetching each instruction
+ * (0 for a hit), and the number of entries of the fetch queue between
+ * FETCH and DECODE (0 by default)
+ */
+void SuperscalarPipeline::setFetchMissCycles(const vector<unsigned int> &cycles) {
+  myFetchMissCycles = cycles;
+}
+
+void SuperscalarPipeline::setFetchQueueSize(unsigned int size) {
+  myFetchQueueSize = size;
+}
+
+/* sets which jumps and branches are predicted right at fetch (by a
+ * BranchPredictor), so that the next instruction is fetched right after
+ * them; fetching waits for the destination of the others to be
+ * produced, as it does for every one by default
+ */
+void SuperscalarPipeline::setPredicted(const vector<bool> &predicted) {
+  myPredicted = predicted;
+}
+
+/* sets the paths the results are forwarded along (a set of
+ * ForwardPath), in a config that has them
+ */
+void SuperscalarPipeline::setForwardPaths(int paths) {
+  if (myConfig.forwardPaths != FORWARD_BY_STAGES)
+    myConfig.forwardPaths = paths;
+}
+
+/* returns a newly allocated, uninitialized SuperscalarPipeline with the
+ * same config, width, functional units and cycles
+ */
+Pipeline *SuperscalarPipeline::createEmpty() {
+  SuperscalarPipeline *pipeline = new SuperscalarPipeline(myConfig, myName, myWidth);
+  for (int unit = 0; unit < NUMUNITS; unit++) {
+    pipeline->setNumUnits((FunctionalUnit)unit, myNumUnits[unit]);
+    pipeline->setPipelined((FunctionalUnit)unit, myPipelined[unit]);
+  }
+  for (int op = 0; op <= UNDEFINED; op++) {
+    for (int st = 0; st < NUMSTAGES; st++) {
+      pipeline->setCycles((Opcode)op, st, myCycles[op][st]);
+    }
+  }
+  pipeline->setMemoryCycles(myMemoryCycles);
+  pipeline->setFetchMissCycles(myFetchMissCycles);
+  pipeline->setFetchQueueSize(myFetchQueueSize);
+  pipeline->setPredicted(myPredicted);
+  return pipeline;
+}
+
+/* returns the stages that decide when the pipeline stalls
+ */
+PipelineConfig SuperscalarPipeline::getConfig() {
+  return myConfig;
+}
+
+/* returns the cycles instruction i takes to go through the stages when
+ * nothing holds it up, the ones configured for its opcode in each stage
+ * (a cache miss counts as holding it up)
+ */
+unsigned int SuperscalarPipeline::getIdealLatency(unsigned int i) {
+  unsigned int latency = 0;
+  for (int st = 0; st < NUMSTAGES; st++) {
+    latency += myCycles[myOpcodes[i]][st];
+  }
+  return latency;
+}
+
+/* models processing the instructions, up to W per stage, computes the
+ * execution time for each instruction and stores it (see getExeTimes())
+ */
+void SuperscalarPipeline::execute() {
+  unsigned int numInstructions = myInstructions.size();
+  for (int st = 0; st < NUMSTAGES; st++) {
+    myStages[st].clear();
+    myDepth[st] = 1;
+    for (int op = 0; op <= UNDEFINED; op++) {
+      myDepth[st] = max(myDepth[st], myCycles[op][st]);
+    }
+  }
+  for (unsigned int i = 0; i < myMemoryCycles.size(); i++) {
+    myDepth[MEMORY] = max(myDepth[MEMORY], myMemoryCycles[i]);
+  }
+  myStageOf.assign(numInstructions, -1);
+  myEnterTime.assign(numInstructions, 0);
+  myMissInst = -1;
+  myNumFrontEndBound = 0;
+  myNumBackEndBound = 0;
+
+  unsigned int nextFetch = 0;
+  unsigned int numCompleted = 0;
+  int time = 0;
+  while (numCompleted < numInstructions) {
+    bool stalledOnRAW = false;    // whether an inst stalled for a RAW in this cycle
+    myTime = time;
+    for (int st = 0; st < NUMSTAGES; st++) {
+      myNumEntered[st] = 0;
+    }
+    for (int unit = 0; unit < NUMUNITS; unit++) {
+      myUnitEntered[unit] = 0;
+    }
+    // as in Pipeline::run(), the later stages make room first
+    for (int st = NUMSTAGES - 1; st >= 0; st--) {
+      if (st == NUMSTAGES - 1) {
+        // the insts in the last stage complete in order, once done with it
+        deque<int> &last = myStages[st];
+        while (!last.empty() && isDone(last.front(), st)) {
+          myExeTimes[last.front()] = time;
+          recordEntry(last.front(), NUMSTAGES, time);
+          myStageOf[last.front()] = NUMSTAGES;
+          myEnterTime[last.front()] = time;
+          numCompleted++;
+          last.pop_front();
+        }
+        for (unsigned int k = 1; k < last.size(); k++) {
+          if (isDone(last[k], st)) {
+            myStallCause = STALL_STRUCTURAL;
+            recordStall(last[k]);
+          }
+        }
+      }
+
+      if (st == 0) {
+        // fetch as many insts as there is room for, up to a jump or an
+        // I-cache miss
+        bool missing = false;
+        while (nextFetch < numInstructions && canMove(nextFetch, st)) {
+          missing = isMissing(nextFetch);
+          if (missing)
+            break;
+          enter(nextFetch, st, time);
+          nextFetch++;
+        }
+        if (missing) {
+          recordStall(nextFetch);
+        } else if (nextFetch < numInstructions && myStallCause == STALL_JUMP) {
+          // if the jump is held up behind a RAW stall, that stall is what
+          // the inst to be fetched waits for
+          if (stalledOnRAW)
+            myStallCause = STALL_STRUCTURAL;
+          recordStall(nextFetch);
+        }
+      } else {
+        deque<int> &previous = myStages[st - 1];
+        bool blocked = false;     // whether the first inst left behind is done
+        while (!previous.empty() && isDone(previous.front(), st - 1)) {
+          int i = previous.front();
+          if (!canMove(i, st)) {
+            blocked = true;
+            break;
+          }
+          previous.pop_front();
+          enter(i, st, time);
+        }
+        // the first inst left behind stalls for the reason it could not
+        // move, the ones after it because it is in their way (unless they
+        // are still busy in the stage themselves); past the first W * D of
+        // FETCH, they are waiting in the fetch queue instead
+        unsigned int numStalled = previous.size();
+        if (st - 1 == FETCH)
+          numStalled = min(numStalled, myWidth * myDepth[FETCH]);
+        for (unsigned int k = 0; k < numStalled; k++) {
+          if (k > 0 || !blocked)
+            myStallCause = STALL_STRUCTURAL;
+          if (!isDone(previous[k], st - 1))
+            continue;
+          recordStall(previous[k]);
+          stalledOnRAW = stalledOnRAW || (myStallCause == STALL_RAW);
+        }
+        // DECODE is short of insts because of the back end if one that
+        // was fetched is held up, or else of the front end, if any are left
+        if (st == DECODE && myNumEntered[st] < myWidth) {
+          if (blocked)
+            myNumBackEndBound++;
+          else if (!previous.empty() || nextFetch < numInstructions)
+            myNumFrontEndBound++;
+        }
+      }
+    }
+    time++;
+  }
+}
+
+/* returns the bytes held by the pipeline
+ */
+size_t SuperscalarPipeline::getMemoryUsage() const {
+  size_t bytes = Pipeline::getMemoryUsage() - sizeof(Pipeline) + sizeof(*this);
+  bytes += MemoryAccount::vectorBytes(myStageOf) + MemoryAccount::vectorBytes(myEnterTime);
+  bytes += MemoryAccount::vectorBytes(myMemoryCycles) + MemoryAccount::vectorBytes(myFetchMissCycles);
+  bytes += myPredicted.capacity() / 8;
+  for (int st = 0; st < NUMSTAGES; st++) {
+    bytes += myStages[st].size() * sizeof(int);
+  }
+  return bytes;
+}
+
+/* returns true if instruction i can move into stage st (be fetched,
+ * for st = FETCH) in this cycle, given where the others are, and sets
+ * myStallCause (and myStallProducer) otherwise
+ */
+bool SuperscalarPipeline::canMove(unsigned int i, int st) {
+  // if the stage is full, W insts entered it in this cycle, or the unit i
+  // needs in it is taken (by every inst using it in the stage, or only
+  // those that entered it in this cycle if it is pipelined)
+  // (FETCH also holds the fetch queue)
+  deque<int> &stage = myStages[st];
+  unsigned int capacity = myWidth * myDepth[st] + (st == FETCH ? myFetchQueueSize : 0);
+  if (stage.size() >= capacity || myNumEntered[st] >= myWidth) {
+    myStallCause = STALL_STRUCTURAL;
+    return false;
+  }
+  int unit = getUnit(i, st);
+  if (unit != -1) {
+    unsigned int used = myPipelined[unit] ? myUnitEntered[unit] : 0;
+    for (unsigned int k = 0; k < stage.size() && !myPipelined[unit]; k++) {
+      if (getUnit(stage[k], st) == unit)
+        used++;
+    }
+    if (used >= myNumUnits[unit]) {
+      myStallCause = STALL_STRUCTURAL;
+      return false;
+    }
+  }
+
+  // nothing is fetched past a jump or branch until its destination is
+  // produced (in an ideal pipeline, where it is produced in FETCH, right
+  // away), unless it was predicted
+  if (st == FETCH && myConfig.jumpDestProduced > FETCH) {
+    for (int jumpSt = FETCH; jumpSt <= myConfig.jumpDestProduced; jumpSt++) {
+      for (unsigned int k = 0; k < myStages[jumpSt].size(); k++) {
+        if (holdsFetch(myStages[jumpSt][k])) {
+          myStallCause = STALL_JUMP;
+          return false;
+        }
+      }
+    }
+  }
+
+  // i leaves stage operandNeeded only once each of its producers has made
+  // its result available: it is not in the stages from st to the one its
+  // result is produced in (included), or the one after it with forwarding,
+  // where it has just been produced (or, with forwarding paths, it can be
+  // forwarded); in an ideal pipeline, where operands are needed in FETCH,
+  // every result is available right away
+  if (st == myConfig.operandNeeded + 1 && myConfig.operandNeeded > FETCH) {
+    const vector<int> &producers = myDepChecker.getRAWProducers(i);
+    int producerSt = NUMSTAGES;
+    int producer = -1;
+    for (unsigned int p = 0; p < producers.size(); p++) {
+      int pSt = myStageOf[producers[p]];
+      bool stalls;
+      if (myConfig.forwardPaths != FORWARD_BY_STAGES) {
+        stalls = !isForwarded(producers[p]);
+      } else {
+        bool memory = myOpcodeTable.isIMMMemory(myOpcodes[producers[p]]);
+        int produced = memory ? myConfig.operandProducedMemory : myConfig.operandProducedOther;
+        int available = produced + (myConfig.forwarding ? 1 : 0);
+        stalls = pSt >= st && pSt <= available;
+      }
+      // the closest producer is the one it stalls on, as in the other pipelines
+      if (stalls && (pSt < producerSt || (pSt == producerSt && producers[p] > producer))) {
+        producerSt = pSt;
+        producer = producers[p];
+      }
+    }
+    if (producer != -1) {
+      myStallCause = STALL_RAW;
+      myStallProducer = producer;
+      return false;
+    }
+  }
+  return true;
+}
+
+/* returns true if the result of producer p is available to an
+ * instruction leaving stage operandNeeded in this cycle, along the
+ * forwarding paths of the config
+ */
+bool SuperscalarPipeline::isForwarded(unsigned int p) {
+  int pSt = myStageOf[p];
+  bool memory = myOpcodeTable.isIMMMemory(myOpcodes[p]);
+  int produced = memory ? myConfig.operandProducedMemory : myConfig.operandProducedOther;
+  if (pSt <= produced)
+    return false;
+  // written back before this cycle, it is read from the register file
+  if (pSt == NUMSTAGES && myEnterTime[p] < myTime)
+    return true;
+  return (myConfig.forwardPaths & (1 << pSt)) != 0;
+}
+
+/* returns the functional unit instruction i uses in stage st, or -1
+ */
+int SuperscalarPipeline::getUnit(unsigned int i, int st) {
+  if (st == MEMORY && myOpcodeTable.isIMMMemory(myOpcodes[i]))
+    return UNIT_MEMORY;
+  if (st == EXECUTE && myOpcodes[i] == MULT)
+    return UNIT_MULTIPLIER;
+  return -1;
+}
+
+/* returns true if fetching instruction i is still held up by its
+ * I-cache miss in this cycle, and sets myStallCause if so
+ */
+bool SuperscalarPipeline::isMissing(unsigned int i) {
+  if (i >= myFetchMissCycles.size() || myFetchMissCycles[i] == 0)
+    return false;
+  // the miss is served from the first cycle i could be fetched
+  if (myMissInst != (int)i) {
+    myMissInst = i;
+    myMissDoneTime = myTime + myFetchMissCycles[i];
+  }
+  if (myTime >= myMissDoneTime)
+    return false;
+  myStallCause = STALL_STRUCTURAL;
+  return true;
+}
+
+/* moves instruction i into stage st at time
+ */
+void SuperscalarPipeline::enter(unsigned int i, int st, int time) {
+  myStages[st].push_back(i);
+  myStageOf[i] = st;
+  myEnterTime[i] = time;
+  myNumEntered[st]++;
+  int unit = getUnit(i, st);
+  if (unit != -1)
+    myUnitEntered[unit]++;
+  recordEntry(i, st, time);
+}
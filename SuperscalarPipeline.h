@@ -0,0 +1,230 @@
+// Name: Maxine Xin
+#ifndef __SUPERSCALARPIPELINE_H__
+#define __SUPERSCALARPIPELINE_H__
+
+#include <deque>
+#include <string>
+
+#include "Pipeline.h"
+
+// functional units, each shared by the insts of a class in one stage
+enum FunctionalUnit {
+  UNIT_MEMORY,        // memory port, used by LB in MEMORY
+  UNIT_MULTIPLIER,    // multiplier, used by MULT in EXECUTE
+  NUMUNITS
+};
+
+/* This class models an in-order pipeline that issues up to W instructions
+ * per cycle: each stage holds up to W instructions, which move on in order
+ * (an instruction cannot pass one that is ahead of it), and up to W are
+ * fetched in each cycle.
+ *
+ * It stalls as the pipeline whose PipelineConfig it is given does (e.g.
+ * the one of a StallPipeline or a ForwardingPipeline): an instruction
+ * cannot leave stage operandNeeded until the results it reads (RAW
+ * dependences from the DependencyChecker) are available, including those
+ * of older instructions of its own bundle, and nothing is fetched past a
+ * jump or branch until its destination is produced, unless it was
+ * predicted (see setPredicted()). In addition, each stage only
+ * holds as many instructions of a class as there are functional units
+ * for it (one memory port and one multiplier by default).
+ *
+ * Each stage takes one cycle by default, but it can take more for every
+ * instruction (a deeper pipeline, e.g. EXECUTE split into 3 stages), or for
+ * the instructions of an opcode (e.g. MULT taking 4 cycles in EXECUTE, or LB
+ * 3 in MEMORY): an instruction only leaves a stage once it has spent its
+ * cycles in it, and a stage of up to D cycles holds up to W * D
+ * instructions, up to W entering it per cycle, still moving on in order. A
+ * functional unit that is not pipelined (the default) is taken as long as
+ * an instruction using it is in the stage; a pipelined one only for the
+ * cycle the instruction enters it. A result is available once its producer
+ * has left the stage it is produced in (the one after it, without
+ * forwarding), so that e.g. MFLO waits for the whole of the MULT before it.
+ * The cycles in MEMORY can also be given for each instruction, so that
+ * each load takes as long as the data cache takes to serve it.
+ *
+ * The front end can be decoupled from the back end by a fetch queue of Q
+ * entries: FETCH then holds up to Q instructions more, which have been
+ * fetched but not decoded yet, so that fetching runs ahead while the back
+ * end stalls. An instruction can also miss in the I-cache, which holds up
+ * fetching it (and everything after it) for the cycles of the miss from the
+ * first cycle it could be fetched, as a structural stall; the instructions
+ * in the queue keep being decoded meanwhile. Each cycle DECODE takes fewer
+ * than W instructions, with instructions left to decode, is counted as
+ * back-end bound if one that was fetched was held up, and front-end bound
+ * otherwise (the queue ran dry, after a jump or an I-cache miss).
+ *
+ * The config can also give a set of forwarding paths instead of when each
+ * result is available (see PipelineConfig), e.g. EX->EX and WB->ID but not
+ * MEM->EX, or change it (setForwardPaths()), to compare their cycles.
+ *
+ * With W = 1, the cycles are the same as the ones of the pipeline the
+ * config comes from. Only execute() simulates the W-wide pipeline: since a
+ * PipelineState holds one instruction per stage, the simulations that
+ * resume from one (ChunkedSimulation, MemoizedSimulation, ...) cannot be
+ * used with it.
+ */
+class SuperscalarPipeline : public Pipeline {
+  public:
+    /* creates a pipeline of width W, stalling as one with config does,
+     * named name, with one of each functional unit
+     */
+    SuperscalarPipeline(const PipelineConfig &config, string name, unsigned int width);
+
+    /* destructor
+     */
+    ~SuperscalarPipeline() {};
+
+    /* sets the number of functional units of kind unit (at least 1)
+     */
+    void setNumUnits(FunctionalUnit unit, unsigned int count);
+
+    /* sets whether functional unit unit is pipelined (takes a new
+     * instruction every cycle) or not (only one at a time, the default)
+     */
+    void setPipelined(FunctionalUnit unit, bool pipelined);
+
+    /* sets the number of cycles (at least 1) every instruction spends in
+     * stage st, or the instructions of opcode op
+     */
+    void setStageCycles(int st, unsigned int cycles);
+    void setCycles(Opcode op, int st, unsigned int cycles);
+
+    /* sets the cycles of each stage from list (e.g. ex=3,mem=2), or of
+     * each opcode from list (e.g. mult=4,lb=3), in EXECUTE, or MEMORY for a
+     * load; returns false if list cannot be read
+     */
+    bool setStageCycles(const string &list);
+    bool setLatencies(const string &list);
+
+    /* sets the pipelined functional units from list (e.g. mult,mem);
+     * returns false if list cannot be read
+     */
+    bool setPipelinedUnits(const string &list);
+
+    /* sets the cycles each instruction spends in MEMORY, e.g. as decided by
+     * a DataCache for each load, over those of its opcode (0 keeps them)
+     */
+    void setMemoryCycles(const vector<unsigned int> &cycles);
+
+    /* sets the cycles an I-cache miss holds up fetching each instruction
+     * (0 for a hit), and the number of entries of the fetch queue between
+     * FETCH and DECODE (0 by default)
+     */
+    void setFetchMissCycles(const vector<unsigned int> &cycles);
+    void setFetchQueueSize(unsigned int size);
+
+    /* sets which jumps and branches are predicted right at fetch (by a
+     * BranchPredictor), so that the next instruction is fetched right after
+     * them; fetching waits for the destination of the others to be
+     * produced, as it does for every one by default
+     */
+    void setPredicted(const vector<bool> &predicted);
+
+    /* sets the paths the results are forwarded along (a set of
+     * ForwardPath), in a config that has them
+     */
+    void setForwardPaths(int paths);
+
+    /* returns a newly allocated, uninitialized SuperscalarPipeline with the
+     * same config, width, functional units and cycles
+     */
+    Pipeline *createEmpty();
+
+    /* returns the stages that decide when the pipeline stalls
+     */
+    PipelineConfig getConfig();
+
+    /* returns the number of instructions issued per cycle, at most (W)
+     */
+    unsigned int getWidth() { return myWidth; };
+
+    /* returns the cycles instruction i takes to go through the stages when
+     * nothing holds it up, the ones configured for its opcode in each stage
+     * (a cache miss counts as holding it up)
+     */
+    unsigned int getIdealLatency(unsigned int i);
+
+    /* models processing the instructions, up to W per stage, computes the
+     * execution time for each instruction and stores it (see getExeTimes())
+     */
+    void execute();
+
+    /* returns, for the last call to execute(), the number of cycles
+     * DECODE took fewer than W instructions because of the front end / the
+     * back end
+     */
+    long long getNumFrontEndBoundCycles() { return myNumFrontEndBound; };
+    long long getNumBackEndBoundCycles() { return myNumBackEndBound; };
+
+    /* returns the bytes held by the pipeline
+     */
+    size_t getMemoryUsage() const;
+
+  private:
+    /* returns true if the result of producer p is available to an
+     * instruction leaving stage operandNeeded in this cycle, along the
+     * forwarding paths of the config
+     */
+    bool isForwarded(unsigned int p);
+
+    /* returns true if instruction i can move into stage st (be fetched,
+     * for st = FETCH) in this cycle, given where the others are, and sets
+     * myStallCause (and myStallProducer) otherwise
+     */
+    bool canMove(unsigned int i, int st);
+
+    /* returns the functional unit instruction i uses in stage st, or -1
+     */
+    int getUnit(unsigned int i, int st);
+
+    /* returns true if instruction i has spent its cycles in the stage st it
+     * is in, by the cycle being simulated
+     */
+    bool isDone(unsigned int i, int st) {
+      unsigned int cycles = myCycles[myOpcodes[i]][st];
+      if (st == MEMORY && i < myMemoryCycles.size() && myMemoryCycles[i] != 0)
+        cycles = myMemoryCycles[i];
+      return myTime >= myEnterTime[i] + (int)cycles;
+    };
+
+    /* returns true if fetching instruction i is still held up by its
+     * I-cache miss in this cycle, and sets myStallCause if so
+     */
+    bool isMissing(unsigned int i);
+
+    /* returns true if fetching waits for the destination of instruction i
+     * to be produced: it is a jump or a branch that was not predicted
+     */
+    bool holdsFetch(unsigned int i) {
+      return myOpcodeTable.isIMMLabel(myOpcodes[i]) && (i >= myPredicted.size() || !myPredicted[i]);
+    };
+
+    /* moves instruction i into stage st at time
+     */
+    void enter(unsigned int i, int st, int time);
+
+    PipelineConfig myConfig;
+    unsigned int myWidth;
+    unsigned int myNumUnits[NUMUNITS];
+    bool myPipelined[NUMUNITS];
+    unsigned int myCycles[UNDEFINED + 1][NUMSTAGES];  // of each opcode in each stage
+    vector<unsigned int> myMemoryCycles;  // of each inst in MEMORY, 0 for its opcode's
+    vector<unsigned int> myFetchMissCycles;  // of the I-cache miss of each inst
+    vector<bool> myPredicted;          // whether each jump or branch is predicted
+    unsigned int myFetchQueueSize;
+    unsigned int myDepth[NUMSTAGES];   // the most cycles of an inst in each stage
+    deque<int> myStages[NUMSTAGES];    // insts in each stage, oldest first
+    vector<int> myStageOf;             // stage of each inst, -1 until fetched,
+                                       // NUMSTAGES once completed
+    vector<int> myEnterTime;           // cycle each inst entered the stage it is in
+    unsigned int myNumEntered[NUMSTAGES];  // insts that entered each stage,
+    unsigned int myUnitEntered[NUMUNITS];  // and each unit, in this cycle
+    int myTime;                        // the cycle being simulated
+    int myMissInst;                    // inst whose I-cache miss is being served,
+    int myMissDoneTime;                // and the cycle it can be fetched
+    long long myNumFrontEndBound;
+    long long myNumBackEndBound;
+};
+
+#endif
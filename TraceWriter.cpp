@@ -0,0 +1,162 @@
+// Name: Maxine Xin
+#include "TraceWriter.h"
+#include "ReportWriter.h"
+
+/* opens filename and starts the list of events
+ */
+TraceWriter::TraceWriter(string filename) {
+  myFile = fopen(filename.c_str(), "w");
+  myBuffer.reserve(BUFFER_SIZE + 256);
+  myBuffer = "{\"traceEvents\":[";
+  myFirstEvent = true;
+  myNextFlowId = 0;
+}
+
+/* finishes the list of events, if not done yet, and closes the file
+ */
+TraceWriter::~TraceWriter() {
+  close();
+}
+
+/* names process pid / track tid of process pid in the viewer, and
+ * keeps the tracks in the order of their tid
+ */
+void TraceWriter::nameProcess(int pid, const string &name) {
+  beginEvent();
+  myBuffer += "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":";
+  append(pid);
+  myBuffer += ",\"args\":{\"name\":";
+  appendString(name);
+  myBuffer += "}}";
+
+  beginEvent();
+  myBuffer += "{\"ph\":\"M\",\"name\":\"process_sort_index\",\"pid\":";
+  append(pid);
+  myBuffer += ",\"args\":{\"sort_index\":";
+  append(pid);
+  myBuffer += "}}";
+}
+
+void TraceWriter::nameTrack(int pid, int tid, const string &name) {
+  beginEvent();
+  myBuffer += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":";
+  append(pid);
+  myBuffer += ",\"tid\":";
+  append(tid);
+  myBuffer += ",\"args\":{\"name\":";
+  appendString(name);
+  myBuffer += "}}";
+
+  beginEvent();
+  myBuffer += "{\"ph\":\"M\",\"name\":\"thread_sort_index\",\"pid\":";
+  append(pid);
+  myBuffer += ",\"tid\":";
+  append(tid);
+  myBuffer += ",\"args\":{\"sort_index\":";
+  append(tid);
+  myBuffer += "}}";
+}
+
+/* writes a slice named name on track tid of process pid, from cycle
+ * start for duration cycles, with the number of its instruction
+ */
+void TraceWriter::addSlice(int pid, int tid, const string &name, long long start,
+                           long long duration, int instNum) {
+  beginEvent();
+  myBuffer += "{\"ph\":\"X\",\"pid\":";
+  append(pid);
+  myBuffer += ",\"tid\":";
+  append(tid);
+  myBuffer += ",\"ts\":";
+  append(start);
+  myBuffer += ",\"dur\":";
+  append(duration);
+  myBuffer += ",\"name\":";
+  appendString(name);
+  myBuffer += ",\"args\":{\"inst\":";
+  append(instNum);
+  myBuffer += "}}";
+}
+
+/* writes the start of a new flow on track tid of process pid, at the slice
+ * enclosing cycle start, and returns the id of the flow
+ */
+long long TraceWriter::addFlowStart(int pid, int tid, const string &name, long long start) {
+  long long id = myNextFlowId++;
+  beginEvent();
+  myBuffer += "{\"ph\":\"s\",\"cat\":\"RAW\",\"pid\":";
+  append(pid);
+  myBuffer += ",\"tid\":";
+  append(tid);
+  myBuffer += ",\"ts\":";
+  append(start);
+  myBuffer += ",\"id\":";
+  append(id);
+  myBuffer += ",\"name\":";
+  appendString(name);
+  myBuffer += "}";
+  return id;
+}
+
+/* writes the finish of flow id on track tid of process pid, at the slice
+ * starting at cycle start
+ */
+void TraceWriter::addFlowFinish(int pid, int tid, long long id, const string &name, long long start) {
+  beginEvent();
+  myBuffer += "{\"ph\":\"f\",\"bp\":\"e\",\"cat\":\"RAW\",\"pid\":";
+  append(pid);
+  myBuffer += ",\"tid\":";
+  append(tid);
+  myBuffer += ",\"ts\":";
+  append(start);
+  myBuffer += ",\"id\":";
+  append(id);
+  myBuffer += ",\"name\":";
+  appendString(name);
+  myBuffer += "}";
+}
+
+/* finishes the list of events, and writes out the buffer
+ */
+void TraceWriter::close() {
+  if (myFile == NULL)
+    return;
+  myBuffer += "]}\n";
+  fwrite(myBuffer.data(), 1, myBuffer.size(), myFile);
+  fclose(myFile);
+  myFile = NULL;
+  myBuffer.clear();
+}
+
+/* starts a new event in the buffer, writing out the buffer if full
+ */
+void TraceWriter::beginEvent() {
+  if (myBuffer.size() >= BUFFER_SIZE && myFile != NULL) {
+    fwrite(myBuffer.data(), 1, myBuffer.size(), myFile);
+    myBuffer.clear();
+  }
+  if (!myFirstEvent)
+    myBuffer += ",\n";
+  myFirstEvent = false;
+}
+
+/* appends a number / a JSON string (quoted and escaped) to the buffer
+ */
+void TraceWriter::append(long long n) {
+  ReportWriter::appendInt(myBuffer, n);
+}
+
+void TraceWriter::appendString(const string &s) {
+  myBuffer += '"';
+  for (unsigned int c = 0; c < s.length(); c++) {
+    if (s[c] == '"' || s[c] == '\\') {
+      myBuffer += '\\';
+      myBuffer += s[c];
+    } else if ((unsigned char)s[c] < 0x20) {
+      myBuffer += ' ';
+    } else {
+      myBuffer += s[c];
+    }
+  }
+  myBuffer += '"';
+}
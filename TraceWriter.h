@@ -0,0 +1,87 @@
+// Name: Maxine Xin
+#ifndef __TRACEWRITER_H__
+#define __TRACEWRITER_H__
+
+#include <cstdio>
+#include <string>
+
+#include "MemoryAccount.h"
+
+using namespace std;
+
+/* This class writes a file in the Chrome trace event format (JSON), which
+ * chrome://tracing and Perfetto can open. Events are written as they come,
+ * through a large buffer, so nothing but the buffer is kept in memory no
+ * matter how many events are written.
+ *
+ * A process (pid) groups tracks (tid); a slice is a named interval on a
+ * track, and a flow is an arrow from a slice to a later one, given as a
+ * start and a finish with the same id, each on the track of its slice.
+ * Times are in cycles, shown as microseconds by the viewers.
+ */
+class TraceWriter {
+  public:
+    /* opens filename and starts the list of events
+     */
+    TraceWriter(string filename);
+
+    /* finishes the list of events, if not done yet, and closes the file
+     */
+    ~TraceWriter();
+
+    /* returns false if the file could not be opened
+     */
+    bool isOpen() { return myFile != NULL; };
+
+    /* returns the bytes held by the writer, mostly its buffer
+     */
+    size_t getMemoryUsage() const { 
+      return sizeof(*this) + MemoryAccount::stringBytes(myBuffer); 
+    };
+
+    /* names process pid / track tid of process pid in the viewer, and
+     * keeps the tracks in the order of their tid
+     */
+    void nameProcess(int pid, const string &name);
+    void nameTrack(int pid, int tid, const string &name);
+
+    /* writes a slice named name on track tid of process pid, from cycle
+     * start for duration cycles, with the number of its instruction
+     */
+    void addSlice(int pid, int tid, const string &name, long long start,
+                  long long duration, int instNum);
+
+    /* writes the start of a new flow on track tid of process pid, at the slice
+     * enclosing cycle start, and returns the id of the flow
+     */
+    long long addFlowStart(int pid, int tid, const string &name, long long start);
+
+    /* writes the finish of flow id on track tid of process pid, at the slice
+     * starting at cycle start
+     */
+    void addFlowFinish(int pid, int tid, long long id, const string &name, long long start);
+
+    /* finishes the list of events, and writes out the buffer
+     */
+    void close();
+
+  private:
+    /* starts a new event in the buffer, writing out the buffer if full
+     */
+    void beginEvent();
+
+    /* appends a number / a JSON string (quoted and escaped) to the buffer
+     */
+    void append(long long n);
+    void appendString(const string &s);
+
+    // the buffer is written out once it holds that many bytes
+    const static size_t BUFFER_SIZE = 1 << 20;
+
+    FILE *myFile;
+    string myBuffer;
+    bool myFirstEvent;
+    long long myNextFlowId;
+};
+
+#endif
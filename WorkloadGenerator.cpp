@@ -0,0 +1,258 @@
+// Name: Maxine Xin
+#include "WorkloadGenerator.h"
+
+#include <cstdlib>
+#include <sstream>
+
+/* generates instructions with seed, all opcodes but J and BEQ equally likely,
+ * no loads or jumps set apart, and no RAW dependence
+ */
+WorkloadGenerator::WorkloadGenerator(unsigned int seed) : myRandom(seed) {
+  myWeights.assign(UNDEFINED, 1);
+  myWeights[J] = 0;
+  myWeights[BEQ] = 0;
+  myLoadFraction = -1;
+  myJumpFraction = -1;
+  myRAWWeights.assign(1, 1);
+}
+
+/* sets the weight of opcode in the mix
+ */
+void WorkloadGenerator::setOpcodeWeight(Opcode opcode, double weight) {
+  if (opcode < UNDEFINED)
+    myWeights[opcode] = weight;
+}
+
+/* sets the fraction of the instructions that are loads / jumps,
+ * instead of the weight of LB / J in the mix; a negative fraction
+ * goes back to the weight
+ */
+void WorkloadGenerator::setLoadFraction(double fraction) {
+  myLoadFraction = fraction;
+}
+
+void WorkloadGenerator::setJumpFraction(double fraction) {
+  myJumpFraction = fraction;
+}
+
+/* sets the weight of each RAW distance d (index d, 0 for no dependence)
+ */
+void WorkloadGenerator::setRAWDistances(const vector<double> &weights) {
+  myRAWWeights = weights;
+  if (myRAWWeights.empty())
+    myRAWWeights.assign(1, 1);
+}
+
+/* sets a typical mix: a fifth of the instructions are loads, one in
+ * twenty a jump, and about half read the result of one of the 4
+ * instructions before
+ */
+void WorkloadGenerator::setTypicalMix() {
+  setLoadFraction(0.2);
+  setJumpFraction(0.05);
+  vector<double> distances;
+  distances.push_back(0.5);
+  distances.push_back(0.2);
+  distances.push_back(0.15);
+  distances.push_back(0.1);
+  distances.push_back(0.05);
+  setRAWDistances(distances);
+}
+
+/* returns the index drawn from weights, each index being as likely as its
+ * weight (0 if they are all 0)
+ */
+static int pick(mt19937 &random, const vector<double> &weights) {
+  double total = 0;
+  for (unsigned int i = 0; i < weights.size(); i++) {
+    total += weights[i];
+  }
+  if (total <= 0)
+    return 0;
+  double u = uniform_real_distribution<double>(0, total)(random);
+  for (unsigned int i = 0; i < weights.size(); i++) {
+    if (u < weights[i])
+      return i;
+    u -= weights[i];
+  }
+  return weights.size() - 1;
+}
+
+/* returns the next instruction, in assembly
+ */
+string WorkloadGenerator::nextLine() {
+  // the opcode: a jump, a load, or one of the rest of the mix
+  Opcode op = UNDEFINED;
+  double u = uniform_real_distribution<double>(0, 1)(myRandom);
+  double jumps = (myJumpFraction >= 0) ? myJumpFraction : 0;
+  double loads = (myLoadFraction >= 0) ? myLoadFraction : 0;
+  if (u < jumps) {
+    op = J;
+  } else if (u < jumps + loads) {
+    op = LB;
+  } else {
+    vector<double> weights = myWeights;
+    if (myJumpFraction >= 0)
+      weights[J] = 0;
+    if (myLoadFraction >= 0)
+      weights[LB] = 0;
+    op = (Opcode)pick(myRandom, weights);
+  }
+
+  // the registers, read and written as DependencyChecker sees them
+  int numOperands = myOpcodes.numOperands(op);
+  vector<string> operands(numOperands);
+  int d = pick(myRandom, myRAWWeights);
+  int dest = -1;
+  int rsPos = myOpcodes.RSposition(op);
+  int rtPos = myOpcodes.RTposition(op);
+  int rdPos = myOpcodes.RDposition(op);
+  int immPos = myOpcodes.IMMposition(op);
+  if (rsPos != -1) {
+    operands[rsPos] = "$" + to_string(pickSource(d));
+    d = 0;
+  }
+  if (rtPos != -1) {
+    if (myOpcodes.getInstType(op) == RTYPE || myOpcodes.isBranch(op)) {
+      operands[rtPos] = "$" + to_string(pickSource(d));
+    } else {
+      dest = pickDestination();
+      operands[rtPos] = "$" + to_string(dest);
+    }
+  }
+  if (rdPos != -1) {
+    dest = pickDestination();
+    operands[rdPos] = "$" + to_string(dest);
+  }
+  addDestination(dest);
+
+  if (immPos != -1) {
+    if (myOpcodes.isIMMLabel(op))
+      operands[immPos] = "label";
+    else if (op == SLL)
+      operands[immPos] = to_string(uniform_int_distribution<int>(0, 31)(myRandom));
+    else
+      operands[immPos] = to_string(uniform_int_distribution<int>(-100, 100)(myRandom));
+  }
+
+  string line = myOpcodes.getInstName(op);
+  for (int i = 0; i < numOperands; i++) {
+    if (myOpcodes.isIMMMemory(op) && i == rsPos)
+      continue;
+    line += (i == 0) ? " " : ", ";
+    if (myOpcodes.isIMMMemory(op) && i == immPos)
+      line += operands[immPos] + "(" + operands[rsPos] + ")";
+    else
+      line += operands[i];
+  }
+  return line;
+}
+
+/* writes numInstructions instructions to out, in assembly or as binary
+ * encodings; returns false if they could not all be written
+ */
+bool WorkloadGenerator::write(ostream &out, unsigned long long numInstructions, bool binary) {
+  ASMParser parser;
+  Instruction inst;
+  string buffer;
+  for (unsigned long long i = 0; i < numInstructions; i++) {
+    string line = nextLine();
+    if (binary) {
+      if (!parser.parseLine(line, inst))
+        return false;
+      buffer += inst.getEncoding();
+    } else {
+      buffer += line;
+    }
+    buffer += '\n';
+    if (buffer.size() >= (1 << 20)) {
+      out.write(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+  }
+  out.write(buffer.data(), buffer.size());
+  return !out.fail();
+}
+
+/* sets weights from a comma-separated list: name=weight for the opcode
+ * mix (e.g. add=2,lb=1), or one weight per RAW distance from 0; returns
+ * false if the list cannot be read
+ */
+bool WorkloadGenerator::setOpcodeMix(const string &list) {
+  vector<double> weights(UNDEFINED, 0);
+  stringstream ss(list);
+  string item;
+  while (getline(ss, item, ',')) {
+    string::size_type equal = item.find('=');
+    if (equal == string::npos)
+      return false;
+    Opcode op = myOpcodes.getOpcode(item.substr(0, equal));
+    if (op == UNDEFINED)
+      return false;
+    weights[op] = atof(item.substr(equal + 1).c_str());
+  }
+  myWeights = weights;
+  return true;
+}
+
+bool WorkloadGenerator::setRAWDistances(const string &list) {
+  vector<double> weights;
+  stringstream ss(list);
+  string item;
+  while (getline(ss, item, ',')) {
+    if (item.empty())
+      return false;
+    weights.push_back(atof(item.c_str()));
+  }
+  if (weights.empty())
+    return false;
+  setRAWDistances(weights);
+  return true;
+}
+
+/* returns a register read by the next instruction: the destination of
+ * the instruction d before it if d > 0 and it has one, otherwise one
+ * not written recently
+ */
+int WorkloadGenerator::pickSource(int d) {
+  if (d > 0 && d <= (int)myRecent.size() && myRecent[myRecent.size() - d] != -1)
+    return myRecent[myRecent.size() - d];
+  for (int tries = 0; tries < 8; tries++) {
+    int reg = uniform_int_distribution<int>(0, NUMREGISTERS - 1)(myRandom);
+    bool recent = false;
+    for (unsigned int i = 0; i < myRecent.size(); i++) {
+      recent = recent || myRecent[i] == reg;
+    }
+    if (!recent)
+      return reg;
+  }
+  // $0 is never written
+  return 0;
+}
+
+/* returns a register the next instruction writes, not written recently
+ */
+int WorkloadGenerator::pickDestination() {
+  int reg = 1;
+  for (int tries = 0; tries < 16; tries++) {
+    reg = uniform_int_distribution<int>(1, NUMREGISTERS - 1)(myRandom);
+    bool recent = false;
+    for (unsigned int i = 0; i < myRecent.size(); i++) {
+      recent = recent || myRecent[i] == reg;
+    }
+    if (!recent)
+      break;
+  }
+  return reg;
+}
+
+/* adds the destination of the next instruction (-1 if none) to the
+ * recent ones
+ */
+void WorkloadGenerator::addDestination(int reg) {
+  // as far back as the largest distance, and at least as deep as a pipeline
+  unsigned int window = max((unsigned int)myRAWWeights.size() - 1, 8u);
+  myRecent.push_back(reg);
+  if (myRecent.size() > window)
+    myRecent.erase(myRecent.begin());
+}
@@ -0,0 +1,100 @@
+// Name: Maxine Xin
+#ifndef __WORKLOADGENERATOR_H__
+#define __WORKLOADGENERATOR_H__
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ASMParser.h"
+#include "OpcodeTable.h"
+
+using namespace std;
+
+/* This class generates synthetic lists of instructions, of any length, as
+ * MIPS assembly or as binary encodings (one instruction per line, as read
+ * by ASMParser / BinaryParser), from a seed, so that the same settings
+ * always give the same instructions.
+ *
+ * Each instruction is drawn from the opcode mix (a weight per Opcode), with
+ * the fraction of loads (LB) and of jumps (J) set apart. Its first source
+ * register, if it has one, reads the result of the instruction d before it,
+ * with d drawn from the RAW distance distribution (d = 0 meaning no
+ * dependence); the other source registers are not written recently, and a
+ * destination register is not written again within the largest distance, so
+ * the instruction d before is the closest producer.
+ */
+class WorkloadGenerator {
+  public:
+    /* generates instructions with seed, all opcodes but J and BEQ equally likely,
+     * no loads or jumps set apart, and no RAW dependence
+     */
+    WorkloadGenerator(unsigned int seed);
+
+    /* sets the weight of opcode in the mix
+     */
+    void setOpcodeWeight(Opcode opcode, double weight);
+
+    /* sets the fraction of the instructions that are loads / jumps,
+     * instead of the weight of LB / J in the mix; a negative fraction
+     * goes back to the weight
+     */
+    void setLoadFraction(double fraction);
+    void setJumpFraction(double fraction);
+
+    /* sets the weight of each RAW distance d (index d, 0 for no dependence)
+     */
+    void setRAWDistances(const vector<double> &weights);
+
+    /* sets a typical mix: a fifth of the instructions are loads, one in
+     * twenty a jump, and about half read the result of one of the 4
+     * instructions before
+     */
+    void setTypicalMix();
+
+    /* returns the next instruction, in assembly
+     */
+    string nextLine();
+
+    /* writes numInstructions instructions to out, in assembly or as binary
+     * encodings; returns false if they could not all be written
+     */
+    bool write(ostream &out, unsigned long long numInstructions, bool binary);
+
+    /* sets weights from a comma-separated list: name=weight for the opcode
+     * mix (e.g. add=2,lb=1), or one weight per RAW distance from 0; returns
+     * false if the list cannot be read
+     */
+    bool setOpcodeMix(const string &list);
+    bool setRAWDistances(const string &list);
+
+  private:
+    /* returns a register read by the next instruction: the destination of
+     * the instruction d before it if d > 0 and it has one, otherwise one
+     * not written recently
+     */
+    int pickSource(int d);
+
+    /* returns a register the next instruction writes, not written recently
+     */
+    int pickDestination();
+
+    /* adds the destination of the next instruction (-1 if none) to the
+     * recent ones
+     */
+    void addDestination(int reg);
+
+    const static int NUMREGISTERS = 32;
+
+    mt19937 myRandom;
+    OpcodeTable myOpcodes;
+    vector<double> myWeights;          // of each Opcode in the mix
+    double myLoadFraction;             // or -1 to use the weight of LB
+    double myJumpFraction;             // or -1 to use the weight of J
+    vector<double> myRAWWeights;       // of each distance, from 0
+    vector<int> myRecent;              // destination of the last instructions (-1 if none),
+                                       // most recent last
+};
+
+#endif
@@ -0,0 +1,6 @@
+add $9, $2, $3
+add $1, $9, $9
+add $4, $1, $1
+add $6, $1, $5
+add $7, $6, $6
+add $8, $7, $7
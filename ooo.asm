@@ -0,0 +1,3 @@
+lb $1, 100($2)
+add $3, $1, $4
+add $5, $1, $6